@@ -3,8 +3,13 @@
 
 // Version 1.2
 
+// Transport of the default context, the one behind the lumen_* functions
+// without a ctx argument.
 extern void lumen_write_bytes(uint8_t *data, uint32_t length);
 extern uint16_t lumen_get_byte();
+#if USE_BLOCK_READ
+extern uint32_t lumen_get_bytes(uint8_t *data, uint32_t max);
+#endif
 
 typedef union {
   struct
@@ -99,200 +104,530 @@ typedef enum lumen_project_update_response {
 volatile bool g_is_updating = false;
 #endif
 
-static uint8_t quantityOfPacketsAvailable = 0;
+#define kDataLength LUMEN_DATA_LENGTH
+#define kReadMultipleMax 32
+#define kSchemaNone 0xFF
+#if USE_CRC
+#define kCrcLength 2
+#else
+#define kCrcLength 0
+#endif
+
+static lumen_ctx_t _defaultCtx;
+static bool _defaultCtxReady = false;
+
+#if USE_PROJECT_UPDATE
+// A project update takes over the default context's link until it finishes.
+#define lumen_ctx_is_updating(ctx) (g_is_updating && (ctx) == &_defaultCtx)
+#endif
+
+#if USE_CRC || USE_PROJECT_UPDATE
+// CRC16 with polynomial 0xA001 (reflected 0x8005), one entry per byte value.
+static const uint16_t kCrcTable[256] = {
+  0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+  0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+  0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+  0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+  0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+  0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+  0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+  0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+  0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+  0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+  0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+  0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+  0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+  0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+  0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+  0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+  0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+  0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+  0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+  0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+  0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+  0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+  0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+  0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+  0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+  0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+  0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+  0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+  0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+  0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+  0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+  0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+static inline uint16_t lumen_crc16_update(uint16_t crc, uint8_t data) {
+  return (crc >> 8) ^ kCrcTable[(uint8_t)(crc ^ data)];
+}
 
-static lumen_packet_t packets[QUANTITY_OF_PACKETS];
-static bool occupiedSlots[QUANTITY_OF_PACKETS];
+static uint16_t lumen_crc16(uint16_t crc, const uint8_t *data, uint32_t length) {
+  while (length--) {
+    crc = lumen_crc16_update(crc, *data++);
+  }
+  return crc;
+}
+#endif
 
 #if USE_CRC
-static u16_union_t _crc;
+static inline void calculate_crc(uint16_t *crc, uint16_t data) {
+  *crc = lumen_crc16_update(*crc, (uint8_t)data);
+}
 #endif
 
+#define kEscapeWordSize sizeof(uint32_t)
+#define kEscapeOnes 0x01010101UL
+#define kEscapeHighs 0x80808080UL
+#define kEscapeHasZeroByte(x) (((x) - kEscapeOnes) & ~(x) & kEscapeHighs)
+#define kEscapeHasByte(x, b) kEscapeHasZeroByte((x) ^ ((uint32_t)(b) * kEscapeOnes))
 
-#define kDataLength (MAX_STRING_SIZE + 8) * 2
-static uint32_t _dataIndex;
-static uint16_t receivedData;
-static uint8_t _dataIn[kDataLength];
-static uint8_t _dataOut[QUANTITY_OF_DATABUFFER_FOR_RETRY][kDataLength];
-#if USE_ACK
-static uint32_t _dataOutElapsedTime[QUANTITY_OF_DATABUFFER_FOR_RETRY];
-static uint8_t _dataOutRetries[QUANTITY_OF_DATABUFFER_FOR_RETRY] = { 0, 0, 0, 0, 0 };
-static uint8_t _dataOutLengths[QUANTITY_OF_DATABUFFER_FOR_RETRY] = { 0, 0, 0, 0, 0 };
-static uint8_t _dataOutIndex = 1;
+static inline bool lumen_escape_word_is_clean(const uint8_t *data) {
+  uint32_t word;
+  memcpy(&word, data, kEscapeWordSize);
+  return !(kEscapeHasByte(word, START_FLAG) | kEscapeHasByte(word, END_FLAG) | kEscapeHasByte(word, ESCAPE_FLAG));
+}
+
+// Payloads shorter than this (numbers, short labels) are escaped a byte at a
+// time: the word scan only pays off once there are runs to bulk copy.
+#define kEscapeWordMinLength 16
+// Bytes escaped one by one after a word that needed escaping, so that
+// flag-heavy input does not pay for a failed word test every 4 bytes.
+#define kEscapeBackoff 16
+
+static inline uint32_t lumen_escape_bytes(uint8_t *out, const uint8_t *data, uint32_t length) {
+  uint32_t outIndex = 0;
+  for (uint32_t i = 0; i < length; ++i) {
+    if (data[i] == START_FLAG || data[i] == END_FLAG || data[i] == ESCAPE_FLAG) {
+      out[outIndex] = ESCAPE_FLAG;
+      ++outIndex;
+      out[outIndex] = data[i] ^ XOR_FLAG;
+    } else {
+      out[outIndex] = data[i];
+    }
+    ++outIndex;
+  }
+  return outIndex;
+}
+
+// Copies the payload into out escaping START_FLAG, END_FLAG and ESCAPE_FLAG.
+// Long payloads are scanned a word at a time and the runs that need no
+// escaping are bulk copied. Returns the number of bytes written to out (at
+// most 2 * length).
+static uint32_t lumen_escape_copy(uint8_t *out, const uint8_t *data, uint32_t length) {
+  if (length < kEscapeWordMinLength) {
+    return lumen_escape_bytes(out, data, length);
+  }
+
+  uint32_t outIndex = 0;
+  uint32_t i = 0;
+  uint32_t end;
+
+  while ((i + kEscapeWordSize) <= length) {
+    end = i;
+    while ((end + kEscapeWordSize) <= length && lumen_escape_word_is_clean(&data[end])) {
+      end += kEscapeWordSize;
+    }
+    if (end > i) {
+      memcpy(&out[outIndex], &data[i], end - i);
+      outIndex += end - i;
+      i = end;
+      continue;
+    }
+    end = i + kEscapeBackoff;
+    if (end > length) {
+      end = length;
+    }
+    outIndex += lumen_escape_bytes(&out[outIndex], &data[i], end - i);
+    i = end;
+  }
+
+  outIndex += lumen_escape_bytes(&out[outIndex], &data[i], length - i);
+  return outIndex;
+}
+
+#if USE_TX_QUEUE
+static bool lumen_tx_push(lumen_tx_ring_t *ring, const uint8_t *data, uint32_t length) {
+  if (length > (ring->size - ring->pending)) {
+    ++ring->rejected;
+    return false;
+  }
+
+  uint32_t firstPart = ring->size - ring->head;
+  if (firstPart > length) {
+    firstPart = length;
+  }
+  memcpy(&ring->data[ring->head], data, firstPart);
+  memcpy(&ring->data[0], &data[firstPart], length - firstPart);
+
+  ring->head = (ring->head + length) % ring->size;
+  ring->pending += length;
+  if (ring->pending > ring->peak) {
+    ring->peak = ring->pending;
+  }
+  return true;
+}
+
+// Sends up to budget bytes from ring in contiguous spans. With untilEndOfFrame
+// it stops right after the next END_FLAG. Returns the number of bytes sent and
+// sets *endOfFrame when the last byte sent closed a frame.
+static uint32_t lumen_tx_send(lumen_ctx_t *ctx, lumen_tx_ring_t *ring, uint32_t budget, bool untilEndOfFrame, bool *endOfFrame) {
+  uint32_t sent = 0;
+
+  while (ring->pending > 0 && sent < budget) {
+    uint32_t span = ring->size - ring->tail;
+    if (span > ring->pending) {
+      span = ring->pending;
+    }
+    if (span > (budget - sent)) {
+      span = budget - sent;
+    }
+    if (untilEndOfFrame) {
+      uint8_t *end = (uint8_t *)memchr(&ring->data[ring->tail], END_FLAG, span);
+      if (end) {
+        span = (uint32_t)(end - &ring->data[ring->tail]) + 1;
+      }
+    }
+
+    ctx->writeBytes(ctx->user, &ring->data[ring->tail], span);
+
+    *endOfFrame = (ring->data[ring->tail + span - 1] == END_FLAG);
+    ring->tail = (ring->tail + span) % ring->size;
+    ring->pending -= span;
+    sent += span;
+
+    if (untilEndOfFrame && *endOfFrame) {
+      break;
+    }
+  }
+  return sent;
+}
+
+uint32_t lumen_ctx_tx_drain(lumen_ctx_t *ctx, uint32_t budget) {
+  uint32_t sent = 0;
+  bool endOfFrame = true;
+
+  if (ctx->txOpenFrameLane != kQuantityOfLanes) {
+    endOfFrame = false;
+    sent += lumen_tx_send(ctx, &ctx->txLanes[ctx->txOpenFrameLane], budget, true, &endOfFrame);
+    if (!endOfFrame) {
+      return sent;
+    }
+    ctx->txOpenFrameLane = kQuantityOfLanes;
+  }
+
+  for (uint8_t lane = 0; lane < kQuantityOfLanes && sent < budget; ++lane) {
+    if (ctx->txLanes[lane].pending == 0) {
+      continue;
+    }
+    sent += lumen_tx_send(ctx, &ctx->txLanes[lane], budget - sent, false, &endOfFrame);
+    if (!endOfFrame) {
+      ctx->txOpenFrameLane = (lumen_tx_lane_t)lane;
+    }
+  }
+  return sent;
+}
+
+void lumen_ctx_tx_flush(lumen_ctx_t *ctx) {
+  lumen_ctx_tx_drain(ctx, lumen_ctx_tx_pending(ctx));
+}
+
+uint32_t lumen_ctx_tx_pending(lumen_ctx_t *ctx) {
+  return ctx->txLanes[kLaneRealtime].pending + ctx->txLanes[kLaneBulk].pending;
+}
+
+void lumen_ctx_tx_stats(lumen_ctx_t *ctx, lumen_tx_lane_t lane, uint32_t *peak, uint32_t *rejected) {
+  if (lane >= kQuantityOfLanes) {
+    return;
+  }
+  if (peak) {
+    *peak = ctx->txLanes[lane].peak;
+  }
+  if (rejected) {
+    *rejected = ctx->txLanes[lane].rejected;
+  }
+}
+#endif
+
+// Hands finished frames to the transport, or to the TX queue when it is in
+// use. Returns false if the queue had no room for them.
+static bool lumen_transmit(lumen_ctx_t *ctx, const uint8_t *data, uint32_t length) {
+#if USE_TX_QUEUE
+  return lumen_tx_push(&ctx->txLanes[ctx->txLane], data, length);
 #else
-static uint8_t _dataOutIndex = 0;
+  ctx->writeBytes(ctx->user, (uint8_t *)data, length);
+  return true;
 #endif
-static uint32_t _command;
-static u16_union_t _address;
-static PayloadIndex_t _payloadIndex;
+}
 
-lumen_packet_t *readingPacket;
-static bool reading = false;
+#if USE_BATCH
+static bool lumen_batch_flush(lumen_ctx_t *ctx) {
+  bool sent = true;
+  if (ctx->batchLength > 0) {
+    sent = lumen_transmit(ctx, ctx->batchOut, ctx->batchLength);
+    if (!sent) {
+      ctx->batchFailed = true;
+#if USE_SHADOW
+      // We no longer know which of the batched values reached the HMI.
+      lumen_ctx_shadow_invalidate_all(ctx);
+#endif
+    }
+    ctx->batchLength = 0;
+  }
+  return sent;
+}
+#endif
 
-#if USE_CRC
-void calculate_crc(uint16_t data) {
-  static uint32_t pos;
-  static uint32_t i;
-  static uint32_t z = 0;
-  static uint32_t u = 0x0001;
-  static uint32_t o = 8;
-  static uint32_t p = 0xA001;
-
-  _crc.value ^= data;
-  ++data;
-
-  for (i = o; z != i; --i) {
-    if (z != (u & _crc.value)) {
-      _crc.value >>= u;
-      _crc.value ^= p;
-    } else {
-      _crc.value >>= u;
+// Every encoded frame leaves through here. While a batch is open the frame is
+// appended to ctx->batchOut instead of being handed to the transport right away.
+static bool lumen_emit(lumen_ctx_t *ctx, const uint8_t *data, uint32_t length) {
+#if USE_BATCH
+  if (ctx->batchDepth > 0) {
+    if ((ctx->batchLength + length) > BATCH_BUFFER_SIZE) {
+      lumen_batch_flush(ctx);
+    }
+    if (length <= BATCH_BUFFER_SIZE) {
+      memcpy(&ctx->batchOut[ctx->batchLength], data, length);
+      ctx->batchLength += length;
+      return true;
+    }
+  }
+  if (!lumen_transmit(ctx, data, length)) {
+    if (ctx->batchDepth > 0) {
+      ctx->batchFailed = true;
     }
+    return false;
+  }
+  return true;
+#else
+  return lumen_transmit(ctx, data, length);
+#endif
+}
+
+#if USE_TX_QUEUE
+lumen_tx_lane_t lumen_ctx_tx_select_lane(lumen_ctx_t *ctx, lumen_tx_lane_t lane) {
+  lumen_tx_lane_t previous = ctx->txLane;
+  if (lane >= kQuantityOfLanes || lane == previous) {
+    return previous;
   }
+#if USE_BATCH
+  // Frames already batched belong to the lane they were written on.
+  lumen_batch_flush(ctx);
+#endif
+  ctx->txLane = lane;
+  return previous;
 }
 #endif
 
-static uint8_t writeTempData;
+#if USE_SHADOW
+// Payloads of up to 4 bytes (every number) are their own key, so they never
+// collide. Longer ones: FNV-1a over the payload, seeded with its length.
+uint32_t lumen_shadow_hash(const uint8_t *data, uint32_t length) {
+  if (length <= sizeof(uint32_t)) {
+    uint32_t key = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+      key |= (uint32_t)data[i] << (8 * i);
+    }
+    return key;
+  }
+  uint32_t hash = 2166136261UL ^ length;
+  for (uint32_t i = 0; i < length; ++i) {
+    hash ^= data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+// Returns true when address already holds the value of this length and hash.
+// Otherwise records it as the new value of address and returns false.
+static bool lumen_shadow_check(lumen_ctx_t *ctx, uint16_t address, uint32_t hash, uint32_t length) {
+  lumen_shadow_entry_t *entry = &ctx->shadow[address % SHADOW_SIZE];
+
+  if (entry->valid && entry->address == address && entry->length == length && entry->hash == hash) {
+    ++ctx->shadowHits;
+    return true;
+  }
+  entry->address = address;
+  entry->length = (uint16_t)length;
+  entry->hash = hash;
+  entry->valid = true;
+  ++ctx->shadowMisses;
+  return false;
+}
+
+void lumen_ctx_shadow_invalidate(lumen_ctx_t *ctx, uint16_t address) {
+  lumen_shadow_entry_t *entry = &ctx->shadow[address % SHADOW_SIZE];
+  if (entry->address == address) {
+    entry->valid = false;
+  }
+}
+
+void lumen_ctx_shadow_invalidate_all(lumen_ctx_t *ctx) {
+  for (uint16_t i = 0; i < SHADOW_SIZE; ++i) {
+    ctx->shadow[i].valid = false;
+  }
+}
+
+void lumen_ctx_shadow_stats(lumen_ctx_t *ctx, uint32_t *hits, uint32_t *misses) {
+  if (hits) {
+    *hits = ctx->shadowHits;
+  }
+  if (misses) {
+    *misses = ctx->shadowMisses;
+  }
+}
+#endif
 
 #if USE_ACK
 uint32_t elapsed_time_in_ms = 0;
-void lumen_ack_trigger(uint32_t time_in_ms) {
+void lumen_ctx_ack_trigger(lumen_ctx_t *ctx, uint32_t time_in_ms) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return;
 #endif
 
   for (uint8_t dataOutIndex = 1; dataOutIndex < QUANTITY_OF_DATABUFFER_FOR_RETRY; ++dataOutIndex) {
-    if (_dataOutRetries[dataOutIndex] > 0) {
-      _dataOutElapsedTime[dataOutIndex] += time_in_ms;
-      if (_dataOutElapsedTime[dataOutIndex] >= ELAPSED_TIME_TO_RETRY) {
-        lumen_write_bytes(_dataOut[dataOutIndex], _dataOutLengths[dataOutIndex]);
-        --_dataOutRetries[dataOutIndex];
-        _dataOutElapsedTime[dataOutIndex] = 0;
+    if (ctx->dataOutRetries[dataOutIndex] > 0) {
+      ctx->dataOutElapsedTime[dataOutIndex] += time_in_ms;
+      if (ctx->dataOutElapsedTime[dataOutIndex] >= ELAPSED_TIME_TO_RETRY) {
+        lumen_transmit(ctx, ctx->dataOut[dataOutIndex], ctx->dataOutLengths[dataOutIndex]);
+        --ctx->dataOutRetries[dataOutIndex];
+        ctx->dataOutElapsedTime[dataOutIndex] = 0;
       }
     }
   }
 }
 #endif
 
-uint32_t lumen_write(uint16_t address, uint8_t *data, uint32_t length) {
+uint32_t lumen_ctx_write(lumen_ctx_t *ctx, uint16_t address, uint8_t *data, uint32_t length) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return 0;
 #endif
 
-  static uint32_t outDataIndex;
-  outDataIndex = 0;
+#if USE_SHADOW
+  if (lumen_shadow_check(ctx, address, lumen_shadow_hash(data, length), length)) {
+    return length;
+  }
+#endif
+
+#if USE_CRC
+  u16_union_t crc;
+#endif
+  uint8_t writeTempData;
+  uint32_t outDataIndex = 0;
 
-  _dataOut[_dataOutIndex][outDataIndex] = START_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = START_FLAG;
   ++outDataIndex;
 
-  _dataOut[_dataOutIndex][outDataIndex] = WRITE_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = WRITE_FLAG;
 #if USE_CRC
-  _crc.value = 0xFFFF;
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  crc.value = 0xFFFF;
+  calculate_crc(&crc.value, ctx->dataOut[ctx->dataOutIndex][outDataIndex]);
 #endif
   ++outDataIndex;
 
   writeTempData = address & 0xFF;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
   writeTempData = address >> 8;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
 #if USE_CRC
-  for (uint16_t i = 0; i < length; i++) {
-    calculate_crc(data[i]);
-  }
+  crc.value = lumen_crc16(crc.value, data, length);
 #endif
 
-  for (uint16_t i = 0; i < length; i++) {
-    if (data[i] == START_FLAG || data[i] == END_FLAG || data[i] == ESCAPE_FLAG) {
-      _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
-      ++outDataIndex;
-      _dataOut[_dataOutIndex][outDataIndex] = data[i] ^ XOR_FLAG;
-      ++outDataIndex;
-    } else {
-      _dataOut[_dataOutIndex][outDataIndex] = data[i];
-      ++outDataIndex;
-    }
-  }
+  outDataIndex += lumen_escape_copy(&ctx->dataOut[ctx->dataOutIndex][outDataIndex], data, length);
 
 #if USE_ACK
-  _dataOut[_dataOutIndex][outDataIndex] = _dataOutIndex;
+  // The retry slot goes out like any other byte: slots 0x12, 0x13 and 0x7D
+  // would otherwise read as flags.
+  writeTempData = (uint8_t)ctx->dataOutIndex;
 #if USE_CRC
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  calculate_crc(&crc.value, writeTempData);
 #endif
+  if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ++outDataIndex;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+  } else {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
+  }
   ++outDataIndex;
-  _dataOut[_dataOutIndex][outDataIndex] = 0;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = 0;
 #if USE_CRC
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  calculate_crc(&crc.value, ctx->dataOut[ctx->dataOutIndex][outDataIndex]);
 #endif
   ++outDataIndex;
 #endif
 
 #if USE_CRC
-  if ((_crc.byte.high == (uint8_t)START_FLAG) || (_crc.byte.high == (uint8_t)END_FLAG)
-      || (_crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.high == (uint8_t)START_FLAG) || (crc.byte.high == (uint8_t)END_FLAG)
+      || (crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.high ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.high ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.high;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.high;
     ++outDataIndex;
   }
 
-  if ((_crc.byte.low == (uint8_t)START_FLAG) || (_crc.byte.low == (uint8_t)END_FLAG)
-      || (_crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.low == (uint8_t)START_FLAG) || (crc.byte.low == (uint8_t)END_FLAG)
+      || (crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.low ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.low ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.low;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.low;
     ++outDataIndex;
   }
 #endif
 
-  _dataOut[_dataOutIndex][outDataIndex] = END_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = END_FLAG;
   ++outDataIndex;
 
-  lumen_write_bytes(_dataOut[_dataOutIndex], outDataIndex);
+  if (!lumen_emit(ctx, ctx->dataOut[ctx->dataOutIndex], outDataIndex)) {
+#if USE_SHADOW
+    lumen_ctx_shadow_invalidate(ctx, address);
+#endif
+    return 0;
+  }
 
 #if USE_ACK
-  _dataOutLengths[_dataOutIndex] = outDataIndex;
-  _dataOutElapsedTime[_dataOutIndex] = 0;
-  _dataOutRetries[_dataOutIndex] = QUANTITY_OF_RETRIES;
-  for (_dataOutIndex = 1; _dataOutIndex < QUANTITY_OF_DATABUFFER_FOR_RETRY; ++_dataOutIndex) {
-    if (_dataOutRetries[_dataOutIndex] == 0) {
+  ctx->dataOutLengths[ctx->dataOutIndex] = outDataIndex;
+  ctx->dataOutElapsedTime[ctx->dataOutIndex] = 0;
+  ctx->dataOutRetries[ctx->dataOutIndex] = QUANTITY_OF_RETRIES;
+  for (ctx->dataOutIndex = 1; ctx->dataOutIndex < QUANTITY_OF_DATABUFFER_FOR_RETRY; ++ctx->dataOutIndex) {
+    if (ctx->dataOutRetries[ctx->dataOutIndex] == 0) {
       break;
     }
   }
-  if (_dataOutIndex >= QUANTITY_OF_DATABUFFER_FOR_RETRY) {
-    _dataOutIndex = QUANTITY_OF_DATABUFFER_FOR_RETRY - 1;
+  if (ctx->dataOutIndex >= QUANTITY_OF_DATABUFFER_FOR_RETRY) {
+    ctx->dataOutIndex = QUANTITY_OF_DATABUFFER_FOR_RETRY - 1;
   }
 #endif
 
@@ -300,163 +635,193 @@ uint32_t lumen_write(uint16_t address, uint8_t *data, uint32_t length) {
 }
 
 
-uint32_t lumen_write_variable_list(uint16_t address, uint16_t index, uint8_t *data, uint32_t length) {
+#if !USE_ACK
+uint32_t lumen_ctx_write_encoded(lumen_ctx_t *ctx, uint16_t address, uint32_t payloadHash, uint32_t payloadLength,
+                                 const uint8_t *frame, uint32_t length) {
+
+#if USE_PROJECT_UPDATE
+  if (lumen_ctx_is_updating(ctx))
+    return 0;
+#endif
+
+#if USE_SHADOW
+  if (lumen_shadow_check(ctx, address, payloadHash, payloadLength)) {
+    return length;
+  }
+#else
+  (void)address;
+  (void)payloadHash;
+  (void)payloadLength;
+#endif
+
+  if (!lumen_emit(ctx, frame, length)) {
+#if USE_SHADOW
+    lumen_ctx_shadow_invalidate(ctx, address);
+#endif
+    return 0;
+  }
+  return length;
+}
+#endif
+
+uint32_t lumen_ctx_write_variable_list(lumen_ctx_t *ctx, uint16_t address, uint16_t index, uint8_t *data, uint32_t length) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return 0;
 #endif
 
-  static uint32_t outDataIndex;
-  outDataIndex = 0;
+#if USE_CRC
+  u16_union_t crc;
+#endif
+  uint8_t writeTempData;
+  uint32_t outDataIndex = 0;
 
-  _dataOut[_dataOutIndex][outDataIndex] = START_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = START_FLAG;
   ++outDataIndex;
 
-  _dataOut[_dataOutIndex][outDataIndex] = WRITE_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = WRITE_FLAG;
 #if USE_CRC
-  _crc.value = 0xFFFF;
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  crc.value = 0xFFFF;
+  calculate_crc(&crc.value, ctx->dataOut[ctx->dataOutIndex][outDataIndex]);
 #endif
   ++outDataIndex;
 
   writeTempData = address & 0xFF;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
   writeTempData = address >> 8;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = writeTempData;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
 #if USE_CRC
-  for (uint16_t i = 0; i < length; i++) {
-    calculate_crc(data[i]);
-  }
+  crc.value = lumen_crc16(crc.value, data, length);
 #endif
 
   u16_union_t _index;
   _index.value = index;
 
   if (_index.byte.low == START_FLAG || _index.byte.low == END_FLAG || _index.byte.low == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _index.byte.low ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = _index.byte.low ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _index.byte.low;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = _index.byte.low;
     ++outDataIndex;
   }
 
   if (_index.byte.high == START_FLAG || _index.byte.high == END_FLAG || _index.byte.high == ESCAPE_FLAG) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _index.byte.high ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = _index.byte.high ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _index.byte.high;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = _index.byte.high;
     ++outDataIndex;
   }
 
-  for (uint16_t i = 0; i < length; i++) {
-    if (data[i] == START_FLAG || data[i] == END_FLAG || data[i] == ESCAPE_FLAG) {
-      _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
-      ++outDataIndex;
-      _dataOut[_dataOutIndex][outDataIndex] = data[i] ^ XOR_FLAG;
-      ++outDataIndex;
-    } else {
-      _dataOut[_dataOutIndex][outDataIndex] = data[i];
-      ++outDataIndex;
-    }
-  }
+  outDataIndex += lumen_escape_copy(&ctx->dataOut[ctx->dataOutIndex][outDataIndex], data, length);
 
 #if USE_ACK
-  _dataOut[_dataOutIndex][outDataIndex] = _dataOutIndex;
+  writeTempData = (uint8_t)ctx->dataOutIndex;
 #if USE_CRC
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  calculate_crc(&crc.value, writeTempData);
 #endif
+  if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+    ++outDataIndex;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData ^ XOR_FLAG;
+  } else {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = writeTempData;
+  }
   ++outDataIndex;
-  _dataOut[_dataOutIndex][outDataIndex] = 0;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = 0;
 #if USE_CRC
-  calculate_crc(_dataOut[_dataOutIndex][outDataIndex]);
+  calculate_crc(&crc.value, ctx->dataOut[ctx->dataOutIndex][outDataIndex]);
 #endif
   ++outDataIndex;
 #endif
 
 #if USE_CRC
-  if ((_crc.byte.high == (uint8_t)START_FLAG) || (_crc.byte.high == (uint8_t)END_FLAG)
-      || (_crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.high == (uint8_t)START_FLAG) || (crc.byte.high == (uint8_t)END_FLAG)
+      || (crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.high ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.high ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.high;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.high;
     ++outDataIndex;
   }
 
-  if ((_crc.byte.low == (uint8_t)START_FLAG) || (_crc.byte.low == (uint8_t)END_FLAG)
-      || (_crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[_dataOutIndex][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.low == (uint8_t)START_FLAG) || (crc.byte.low == (uint8_t)END_FLAG)
+      || (crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.low ^ XOR_FLAG;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.low ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[_dataOutIndex][outDataIndex] = _crc.byte.low;
+    ctx->dataOut[ctx->dataOutIndex][outDataIndex] = crc.byte.low;
     ++outDataIndex;
   }
 #endif
 
-  _dataOut[_dataOutIndex][outDataIndex] = END_FLAG;
+  ctx->dataOut[ctx->dataOutIndex][outDataIndex] = END_FLAG;
   ++outDataIndex;
 
-  lumen_write_bytes(_dataOut[_dataOutIndex], outDataIndex);
+  if (!lumen_emit(ctx, ctx->dataOut[ctx->dataOutIndex], outDataIndex)) {
+    return 0;
+  }
 
 #if USE_ACK
-  _dataOutLengths[_dataOutIndex] = outDataIndex;
-  _dataOutElapsedTime[_dataOutIndex] = 0;
-  _dataOutRetries[_dataOutIndex] = QUANTITY_OF_RETRIES;
-  for (_dataOutIndex = 1; _dataOutIndex < QUANTITY_OF_DATABUFFER_FOR_RETRY; ++_dataOutIndex) {
-    if (_dataOutRetries[_dataOutIndex] == 0) {
+  ctx->dataOutLengths[ctx->dataOutIndex] = outDataIndex;
+  ctx->dataOutElapsedTime[ctx->dataOutIndex] = 0;
+  ctx->dataOutRetries[ctx->dataOutIndex] = QUANTITY_OF_RETRIES;
+  for (ctx->dataOutIndex = 1; ctx->dataOutIndex < QUANTITY_OF_DATABUFFER_FOR_RETRY; ++ctx->dataOutIndex) {
+    if (ctx->dataOutRetries[ctx->dataOutIndex] == 0) {
       break;
     }
   }
-  if (_dataOutIndex >= QUANTITY_OF_DATABUFFER_FOR_RETRY) {
-    _dataOutIndex = QUANTITY_OF_DATABUFFER_FOR_RETRY - 1;
+  if (ctx->dataOutIndex >= QUANTITY_OF_DATABUFFER_FOR_RETRY) {
+    ctx->dataOutIndex = QUANTITY_OF_DATABUFFER_FOR_RETRY - 1;
   }
 #endif
 
   return outDataIndex;
 }
 
-uint32_t lumen_write_packet(lumen_packet_t *packet) {
+uint32_t lumen_ctx_write_packet(lumen_ctx_t *ctx, lumen_packet_t *packet) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return 0;
 #endif
 
+  uint32_t sent = 0;
   switch (packet->type) {
     case kBool:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 1);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 1);
       }
       break;
     case kString:
@@ -468,52 +833,52 @@ uint32_t lumen_write_packet(lumen_packet_t *packet) {
           }
         }
 
-        lumen_write(packet->address, (uint8_t *)packet->data._string, length + 1);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, length + 1);
       }
       break;
     case kChar:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 1);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 1);
       }
       break;
     case kU8:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 1);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 1);
       }
       break;
     case kS8:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 1);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 1);
       }
       break;
     case kU16:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 2);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 2);
       }
       break;
     case kS16:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 2);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 2);
       }
       break;
     case kU32:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 4);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 4);
       }
       break;
     case kS32:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 4);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 4);
       }
       break;
     case kFloat:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 4);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 4);
       }
       break;
     case kDouble:
       {
-        lumen_write(packet->address, (uint8_t *)packet->data._string, 8);
+        sent = lumen_ctx_write(ctx, packet->address, (uint8_t *)packet->data._string, 8);
       }
       break;
     default:
@@ -521,40 +886,75 @@ uint32_t lumen_write_packet(lumen_packet_t *packet) {
       }
       break;
   }
-  return 1;
+  return sent;
+}
+
+#if USE_BATCH
+void lumen_ctx_batch_begin(lumen_ctx_t *ctx) {
+  if (ctx->batchDepth == 0) {
+    ctx->batchLength = 0;
+    ctx->batchFailed = false;
+  }
+  ++ctx->batchDepth;
+}
+
+uint32_t lumen_ctx_batch_append(lumen_ctx_t *ctx, lumen_packet_t *packet) {
+  return lumen_ctx_write_packet(ctx, packet);
+}
+
+bool lumen_ctx_batch_commit(lumen_ctx_t *ctx) {
+  if (ctx->batchDepth == 0) {
+    return true;
+  }
+  --ctx->batchDepth;
+  if (ctx->batchDepth == 0) {
+    lumen_batch_flush(ctx);
+  }
+  return !ctx->batchFailed;
+}
+#endif
+
+// Counts a frame that did not fit in dataIn once, however many bytes it lost.
+static void lumen_rx_overrun(lumen_ctx_t *ctx) {
+  if (!ctx->overrun) {
+    ctx->overrun = true;
+    ++ctx->rxOverruns;
+  }
 }
 
-void ParsePayload() {
-  switch (_payloadIndex) {
+static void ParsePayload(lumen_ctx_t *ctx) {
+  switch (ctx->payloadIndex) {
     case kCommand:
       {
-        _dataIn[_dataIndex] = receivedData;
-        ++_dataIndex;
-        _command = receivedData;
-        _payloadIndex = kAddressLow;
+        ctx->dataIn[ctx->dataIndex] = ctx->receivedData;
+        ++ctx->dataIndex;
+        ctx->command = ctx->receivedData;
+        ctx->payloadIndex = kAddressLow;
       }
       break;
     case kAddressLow:
       {
-        _dataIn[_dataIndex] = receivedData;
-        ++_dataIndex;
-        _address.byte.low = receivedData;
-        _payloadIndex = kAddressHigh;
+        ctx->dataIn[ctx->dataIndex] = ctx->receivedData;
+        ++ctx->dataIndex;
+        ctx->address = (ctx->address & 0xFF00) | (uint8_t)ctx->receivedData;
+        ctx->payloadIndex = kAddressHigh;
       }
       break;
     case kAddressHigh:
       {
-        _dataIn[_dataIndex] = receivedData;
-        ++_dataIndex;
-        _address.byte.high = receivedData;
-        _payloadIndex = kData;
+        ctx->dataIn[ctx->dataIndex] = ctx->receivedData;
+        ++ctx->dataIndex;
+        ctx->address = (ctx->address & 0x00FF) | (uint16_t)(ctx->receivedData << 8);
+        ctx->payloadIndex = kData;
       }
       break;
     case kData:
       {
-        if (_dataIndex < kDataLength) {
-          _dataIn[_dataIndex] = receivedData;
-          ++_dataIndex;
+        if (ctx->dataIndex < kDataLength) {
+          ctx->dataIn[ctx->dataIndex] = ctx->receivedData;
+          ++ctx->dataIndex;
+        } else {
+          lumen_rx_overrun(ctx);
         }
       }
       break;
@@ -563,257 +963,942 @@ void ParsePayload() {
   }
 }
 
-void Pack() {
-  if (_command == READ_FLAG) {
-    if (reading == true) {
-      if (_address.value == readingPacket->address) {
+// Bytes of payload in ctx->dataIn, without the CRC.
+static inline uint32_t lumen_payload_length(lumen_ctx_t *ctx) {
+  return (ctx->dataIndex > (kData + kCrcLength)) ? ctx->dataIndex - kData - kCrcLength : 0;
+}
 
-        uint8_t dataSize = _dataIndex - kData;
+// Copies the payload of the frame in ctx->dataIn into packet and zeroes the
+// rest of packet->data. Anything beyond lumen_data_t is cut off.
+static void lumen_copy_payload(lumen_ctx_t *ctx, lumen_packet_t *packet) {
+  uint32_t dataSize = lumen_payload_length(ctx);
+  if (dataSize > sizeof(packet->data)) {
+    dataSize = sizeof(packet->data);
+    ++ctx->rxTruncated;
+  }
+  memcpy(packet->data._string, &ctx->dataIn[kData], dataSize);
+  memset((uint8_t *)&packet->data + dataSize, 0, sizeof(packet->data) - dataSize);
+}
 
-        for (uint8_t i = 0; i < dataSize; ++i) {
-          readingPacket->data._string[i] = _dataIn[i + kData];
-        }
-        reading = false;
-        return;
-      }
-    }
+#if USE_SCHEMA
+// Payload bytes of each lumen_data_type_t; a string may be shorter.
+static const uint8_t kTypeSize[] = {
+  sizeof(bool), sizeof(char), 1, 1, 2, 2, 4, 4, sizeof(float), sizeof(double), MAX_STRING_SIZE
+};
+
+// Looks up the type of the frame in ctx->dataIn. Returns false when the
+// payload cannot be a value of that type.
+static bool lumen_schema_type(lumen_ctx_t *ctx, lumen_data_type_t *type) {
+  uint16_t index = (uint16_t)(ctx->address - SCHEMA_FIRST_ADDRESS);
+  if (index >= SCHEMA_SIZE || ctx->schema[index] == kSchemaNone) {
+    *type = kString;
+    return true;
+  }
 
-    for (uint8_t packetIndex = 0; packetIndex < QUANTITY_OF_PACKETS; ++packetIndex) {
-      if (occupiedSlots[packetIndex] == true) {
-        if (packets[packetIndex].address == _address.value) {
-          uint8_t dataSize = _dataIndex - kData;
+  *type = (lumen_data_type_t)ctx->schema[index];
+  uint32_t length = lumen_payload_length(ctx);
+  if (*type == kString ? length > kTypeSize[kString] : length != kTypeSize[*type]) {
+    ++ctx->schemaMistyped;
+    return false;
+  }
+  ++ctx->schemaTyped;
+  return true;
+}
 
-          for (uint8_t i = 0; i < dataSize; ++i) {
-            packets[packetIndex].data._string[i] = _dataIn[i + kData];
-          }
-          break;
-        }
-      }
+bool lumen_ctx_set_schema(lumen_ctx_t *ctx, const lumen_variable_t *variables, uint16_t quantity) {
+  bool ok = true;
+  for (uint16_t i = 0; i < quantity; ++i) {
+    uint16_t index = (uint16_t)(variables[i].address - SCHEMA_FIRST_ADDRESS);
+    if (index >= SCHEMA_SIZE || (uint32_t)variables[i].type >= sizeof(kTypeSize)) {
+      ok = false;
+      continue;
     }
+    ctx->schema[index] = (uint8_t)variables[i].type;
+  }
+  return ok;
+}
 
-    for (uint8_t packetIndex = 0; packetIndex < QUANTITY_OF_PACKETS; ++packetIndex) {
-      if (occupiedSlots[packetIndex] == false) {
-
-        packets[packetIndex].address = _address.value;
-
-        uint8_t dataSize = _dataIndex - kData;
+void lumen_ctx_schema_stats(lumen_ctx_t *ctx, uint32_t *typed, uint32_t *mistyped) {
+  if (typed) {
+    *typed = ctx->schemaTyped;
+  }
+  if (mistyped) {
+    *mistyped = ctx->schemaMistyped;
+  }
+}
+#endif
 
-        for (uint8_t i = 0; i < dataSize; ++i) {
-          packets[packetIndex].data._string[i] = _dataIn[i + kData];
-        }
-        occupiedSlots[packetIndex] = true;
+#if USE_COALESCE
+// Returns the queued packet for address when address is coalesced, else NULL.
+static lumen_packet_t *lumen_coalesce_find(lumen_ctx_t *ctx, uint16_t address) {
+  uint8_t range = 0;
+  for (; range < ctx->quantityOfCoalesceRanges; ++range) {
+    if (address >= ctx->coalesce[range].first && address <= ctx->coalesce[range].last) {
+      break;
+    }
+  }
+  if (range == ctx->quantityOfCoalesceRanges) {
+    return NULL;
+  }
 
-        ++quantityOfPacketsAvailable;
-        break;
-      }
+  uint16_t index = ctx->packetsTail;
+  for (uint16_t i = 0; i < ctx->quantityOfPacketsAvailable; ++i) {
+    if (ctx->packets[index].address == address) {
+      return &ctx->packets[index];
+    }
+    if (++index == ctx->packetsCapacity) {
+      index = 0;
     }
   }
-#if USE_ACK
-  else if (_command == ACK_FLAG) {
-    _dataOutRetries[_address.byte.low] = 0;
+  return NULL;
+}
+
+bool lumen_ctx_coalesce(lumen_ctx_t *ctx, uint16_t firstAddress, uint16_t lastAddress) {
+  if (ctx->quantityOfCoalesceRanges >= COALESCE_RANGES || firstAddress > lastAddress) {
+    return false;
   }
+  ctx->coalesce[ctx->quantityOfCoalesceRanges].first = firstAddress;
+  ctx->coalesce[ctx->quantityOfCoalesceRanges].last = lastAddress;
+  ++ctx->quantityOfCoalesceRanges;
+  return true;
+}
+
+void lumen_ctx_coalesce_clear(lumen_ctx_t *ctx) {
+  ctx->quantityOfCoalesceRanges = 0;
+}
 #endif
+
+#if USE_DISPATCH
+bool lumen_ctx_on_range(lumen_ctx_t *ctx, uint16_t firstAddress, uint16_t lastAddress, lumen_handler_fn_t handler, void *user) {
+  if (firstAddress > lastAddress || firstAddress < DISPATCH_FIRST_ADDRESS || lastAddress - DISPATCH_FIRST_ADDRESS >= DISPATCH_SIZE) {
+    return false;
+  }
+  for (uint32_t address = firstAddress; address <= lastAddress; ++address) {
+    lumen_handler_t *entry = &ctx->handlers[address - DISPATCH_FIRST_ADDRESS];
+    entry->handler = handler;
+    entry->user = user;
+  }
+  return true;
 }
 
-uint32_t lumen_available() {
+bool lumen_ctx_on(lumen_ctx_t *ctx, uint16_t address, lumen_handler_fn_t handler, void *user) {
+  return lumen_ctx_on_range(ctx, address, address, handler, user);
+}
 
-#if USE_PROJECT_UPDATE
-  if (g_is_updating)
-    return 0;
+bool lumen_ctx_dispatch(lumen_ctx_t *ctx, lumen_packet_t *packet) {
+  // Addresses below the window wrap around to a large index.
+  uint16_t index = (uint16_t)(packet->address - DISPATCH_FIRST_ADDRESS);
+  if (index >= DISPATCH_SIZE || ctx->handlers[index].handler == NULL) {
+    return false;
+  }
+  ctx->handlers[index].handler(packet, ctx->handlers[index].user);
+  return true;
+}
 #endif
 
-  static bool _started;
-  static bool _escaped;
-#if USE_CRC
-  static bool _crcStarted;
-  static uint16_t _crcIndex;
-  static uint16_t _crcIndexDelayed;
-  static uint16_t _crcData[3];
+#if USE_ASYNC_REQUEST
+#if ASYNC_REQUESTS > 32
+#error "ASYNC_REQUESTS must fit the 32-bit asyncPending mask"
 #endif
 
-  receivedData = lumen_get_byte();
-
-  while (receivedData != 0xFFFF) {
-    if (receivedData == START_FLAG) {
+// Hands the frame in ctx->dataIn to the oldest slot waiting for its
+// address. Returns false when no request is waiting for it.
+static bool lumen_async_complete(lumen_ctx_t *ctx) {
+  lumen_async_request_t *oldest = NULL;
+  uint8_t oldestIndex = 0;
+  for (uint8_t i = 0; i < ASYNC_REQUESTS; ++i) {
+    lumen_async_request_t *request = &ctx->asyncRequests[i];
+    if ((ctx->asyncPending & (1UL << i)) && request->packet->address == ctx->address
+        && (oldest == NULL || request->elapsedTime > oldest->elapsedTime)) {
+      oldest = request;
+      oldestIndex = i;
+    }
+  }
+  if (oldest == NULL) {
+    return false;
+  }
 
-#if USE_CRC
-      _crc.value = 0xFFFF;
-      _crcIndex = 0;
-      _crcStarted = false;
-      _crcIndexDelayed = 0;
+  // Free the slot first so the callback can reuse it.
+  ctx->asyncPending &= ~(1UL << oldestIndex);
+  lumen_copy_payload(ctx, oldest->packet);
+  if (oldest->callback) {
+    oldest->callback(oldest->packet, false, oldest->user);
+  }
+  return true;
+}
 #endif
-      _started = true;
-      _escaped = false;
-      _dataIndex = 0;
-      _payloadIndex = kCommand;
 
-    } else if (receivedData == END_FLAG) {
+static void Pack(lumen_ctx_t *ctx) {
+  if (ctx->command == READ_FLAG) {
+#if USE_SHADOW
+    // The HMI reported this variable, so it may no longer hold what we wrote.
+    lumen_ctx_shadow_invalidate(ctx, ctx->address);
+#endif
 
-#if USE_CRC
-      _crc.value = 0xFFFF;
-      uint16_t _dataIndexOffseted = _dataIndex - 2;
+#if USE_ASYNC_REQUEST
+    if (ctx->asyncPending != 0 && lumen_async_complete(ctx)) {
+      return;
+    }
+#endif
 
-      for (uint16_t pos = 0; pos < _dataIndexOffseted; ++pos) {
-        calculate_crc(_dataIn[pos]);
+    if (ctx->readingPending != 0) {
+      for (uint8_t i = 0; i < ctx->readingQuantity; ++i) {
+        if ((ctx->readingPending & (1UL << i)) && ctx->readingPackets[i].address == ctx->address) {
+          lumen_copy_payload(ctx, &ctx->readingPackets[i]);
+          ctx->readingPending &= ~(1UL << i);
+          return;
+        }
       }
+    }
+
+#if USE_SCHEMA
+    lumen_data_type_t type;
+    if (!lumen_schema_type(ctx, &type)) {
+      return;
+    }
+#endif
+
+#if USE_COALESCE
+    lumen_packet_t *queued = lumen_coalesce_find(ctx, ctx->address);
+    if (queued != NULL) {
+      lumen_copy_payload(ctx, queued);
+#if USE_SCHEMA
+      queued->type = type;
+#endif
+      return;
+    }
+#endif
 
-      if ((_dataIn[_dataIndex - 2] == (_crc.byte.high)) && (_dataIn[_dataIndex - 1] == (_crc.byte.low))) {
-        Pack();
+    // FIFO: a full queue drops the new packet, never one already queued.
+    if (ctx->quantityOfPacketsAvailable < ctx->packetsCapacity) {
+      lumen_packet_t *packet = &ctx->packets[ctx->packetsHead];
+
+      packet->address = ctx->address;
+      lumen_copy_payload(ctx, packet);
+#if USE_SCHEMA
+      packet->type = type;
+#endif
+
+      if (++ctx->packetsHead == ctx->packetsCapacity) {
+        ctx->packetsHead = 0;
       }
-      _crcStarted = false;
-#else
-      Pack();
-
-#endif
-      _started = false;
-      _payloadIndex = kPayloadNull;
-    } else if (_started) {
-      if (_escaped) {
-        receivedData ^= XOR_FLAG;
-        _escaped = false;
-        ParsePayload();
-      } else if (receivedData == ESCAPE_FLAG) {
-        _escaped = true;
-      } else {
-        ParsePayload();
+      ++ctx->quantityOfPacketsAvailable;
+      if (ctx->quantityOfPacketsAvailable > ctx->rxPeak) {
+        ctx->rxPeak = ctx->quantityOfPacketsAvailable;
       }
+    } else {
+      ++ctx->rxDropped;
     }
-    receivedData = lumen_get_byte();
   }
-  return quantityOfPacketsAvailable;
+#if USE_ACK
+  else if (ctx->command == ACK_FLAG) {
+    if ((uint8_t)ctx->address < QUANTITY_OF_DATABUFFER_FOR_RETRY) {
+      ctx->dataOutRetries[(uint8_t)ctx->address] = 0;
+    }
+  }
+#endif
 }
 
-lumen_packet_t *lumen_get_first_packet() {
+#if USE_CRC
+// Folds into rxCrc every byte of dataIn except the last two, which are the
+// CRC itself once END_FLAG arrives.
+static inline void lumen_rx_crc_catch_up(lumen_ctx_t *ctx) {
+  if ((ctx->crcIndexDelayed + 2) < ctx->dataIndex) {
+    uint32_t length = ctx->dataIndex - 2 - ctx->crcIndexDelayed;
+    ctx->rxCrc = lumen_crc16(ctx->rxCrc, &ctx->dataIn[ctx->crcIndexDelayed], length);
+    ctx->crcIndexDelayed += length;
+  }
+}
+#endif
+
+// Hands the frame in ctx->dataIn to Pack at END_FLAG. Frames that are too
+// long, cut short, end on an escape, carry an unknown command or fail the
+// CRC are dropped and counted instead.
+static void lumen_end_frame(lumen_ctx_t *ctx) {
+  if (ctx->overrun) {
+    return;
+  }
+  if (ctx->escaped || ctx->payloadIndex != kData
+      || (ctx->command != READ_FLAG && ctx->command != WRITE_FLAG && ctx->command != ACK_FLAG)) {
+    ++ctx->rxMalformed;
+    return;
+  }
+#if USE_CRC
+  if ((ctx->dataIndex < (kData + kCrcLength)) || (ctx->dataIn[ctx->dataIndex - 2] != (uint8_t)(ctx->rxCrc >> 8)) || (ctx->dataIn[ctx->dataIndex - 1] != (uint8_t)ctx->rxCrc)) {
+    ++ctx->rxMalformed;
+    return;
+  }
+#endif
+  Pack(ctx);
+}
+
+// Runs the frame state machine on ctx->receivedData.
+static void lumen_decode_byte(lumen_ctx_t *ctx) {
+  if (ctx->receivedData == START_FLAG) {
+    if (ctx->started) {
+      // The frame in progress never got its END_FLAG.
+      ++ctx->rxResyncs;
+    }
+
+#if USE_CRC
+    ctx->rxCrc = 0xFFFF;
+    ctx->crcIndexDelayed = 0;
+#endif
+    ctx->started = true;
+    ctx->escaped = false;
+    ctx->overrun = false;
+    ctx->dataIndex = 0;
+    ctx->payloadIndex = kCommand;
+
+  } else if (ctx->receivedData == END_FLAG) {
+    // An END_FLAG outside a frame is line noise.
+    if (ctx->started) {
+      lumen_end_frame(ctx);
+    }
+    ctx->started = false;
+    ctx->payloadIndex = kPayloadNull;
+  } else if (ctx->started) {
+    if (ctx->escaped) {
+      ctx->receivedData ^= XOR_FLAG;
+      ctx->escaped = false;
+      ParsePayload(ctx);
+    } else if (ctx->receivedData == ESCAPE_FLAG) {
+      ctx->escaped = true;
+    } else {
+      ParsePayload(ctx);
+    }
+#if USE_CRC
+    lumen_rx_crc_catch_up(ctx);
+#endif
+  }
+}
+
+// Same result as feeding every byte of data to lumen_decode_byte, but payload
+// runs without START_FLAG, END_FLAG or ESCAPE_FLAG are found a word at a time
+// and copied into dataIn in one go.
+static void lumen_decode_span(lumen_ctx_t *ctx, const uint8_t *data, uint32_t length) {
+  uint32_t i = 0;
+
+  while (i < length) {
+    if (ctx->started && !ctx->escaped && ctx->payloadIndex == kData) {
+      uint32_t end = i;
+      while ((end + kEscapeWordSize) <= length && lumen_escape_word_is_clean(&data[end])) {
+        end += kEscapeWordSize;
+      }
+      while (end < length && data[end] != START_FLAG && data[end] != END_FLAG && data[end] != ESCAPE_FLAG) {
+        ++end;
+      }
+      if (end > i) {
+        uint32_t run = end - i;
+        if (run > (kDataLength - ctx->dataIndex)) {
+          run = kDataLength - ctx->dataIndex;
+          lumen_rx_overrun(ctx);
+        }
+        memcpy(&ctx->dataIn[ctx->dataIndex], &data[i], run);
+        ctx->dataIndex += run;
+#if USE_CRC
+        lumen_rx_crc_catch_up(ctx);
+#endif
+        i = end;
+        continue;
+      }
+    }
+    ctx->receivedData = data[i];
+    lumen_decode_byte(ctx);
+    ++i;
+  }
+}
+
+uint32_t lumen_ctx_available(lumen_ctx_t *ctx) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
-    return NULL;
+  if (lumen_ctx_is_updating(ctx))
+    return 0;
 #endif
 
-  for (uint8_t i = 0; i < QUANTITY_OF_PACKETS; ++i) {
-    if (occupiedSlots[i]) {
-      occupiedSlots[i] = false;
-      --quantityOfPacketsAvailable;
-      return &packets[i];
+  if (ctx->getBytes) {
+    uint8_t buffer[RX_BLOCK_SIZE];
+    uint32_t length = ctx->getBytes(ctx->user, buffer, sizeof(buffer));
+
+    while (length > 0) {
+      lumen_decode_span(ctx, buffer, length);
+      length = ctx->getBytes(ctx->user, buffer, sizeof(buffer));
     }
+    return ctx->quantityOfPacketsAvailable;
   }
-  return NULL;
+
+  ctx->receivedData = ctx->getByte(ctx->user);
+
+  while (ctx->receivedData != 0xFFFF) {
+    lumen_decode_byte(ctx);
+    ctx->receivedData = ctx->getByte(ctx->user);
+  }
+  return ctx->quantityOfPacketsAvailable;
 }
 
-bool lumen_request(lumen_packet_t *packet) {
+lumen_packet_t *lumen_ctx_get_first_packet(lumen_ctx_t *ctx) {
+
+#if USE_PROJECT_UPDATE
+  if (lumen_ctx_is_updating(ctx))
+    return NULL;
+#endif
+
+  if (ctx->quantityOfPacketsAvailable == 0) {
+    return NULL;
+  }
+
+  lumen_packet_t *packet = &ctx->packets[ctx->packetsTail];
+  if (++ctx->packetsTail == ctx->packetsCapacity) {
+    ctx->packetsTail = 0;
+  }
+  --ctx->quantityOfPacketsAvailable;
+  return packet;
+}
+
+// Sends a READ frame for quantity consecutive variables starting at address.
+static bool lumen_send_read(lumen_ctx_t *ctx, uint16_t address, uint8_t quantity) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return false;
 #endif
 
-  static uint32_t outDataIndex;
-  readingPacket = packet;
-  outDataIndex = 0;
+#if USE_CRC
+  u16_union_t crc;
+#endif
+  uint8_t writeTempData;
+  uint32_t outDataIndex = 0;
 
-  _dataOut[0][outDataIndex] = START_FLAG;
+  ctx->dataOut[0][outDataIndex] = START_FLAG;
   ++outDataIndex;
 
-  _dataOut[0][outDataIndex] = READ_FLAG;
+  ctx->dataOut[0][outDataIndex] = READ_FLAG;
 #if USE_CRC
-  _crc.value = 0xFFFF;
-  calculate_crc(_dataOut[0][outDataIndex]);
+  crc.value = 0xFFFF;
+  calculate_crc(&crc.value, ctx->dataOut[0][outDataIndex]);
 #endif
   ++outDataIndex;
 
-  writeTempData = readingPacket->address & 0xFF;
+  writeTempData = address & 0xFF;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[0][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[0][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[0][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[0][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[0][outDataIndex] = writeTempData;
+    ctx->dataOut[0][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
-  writeTempData = readingPacket->address >> 8;
+  writeTempData = address >> 8;
 #if USE_CRC
-  calculate_crc(writeTempData);
+  calculate_crc(&crc.value, writeTempData);
 #endif
   if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
-    _dataOut[0][outDataIndex] = ESCAPE_FLAG;
+    ctx->dataOut[0][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[0][outDataIndex] = writeTempData ^ XOR_FLAG;
+    ctx->dataOut[0][outDataIndex] = writeTempData ^ XOR_FLAG;
   } else {
-    _dataOut[0][outDataIndex] = writeTempData;
+    ctx->dataOut[0][outDataIndex] = writeTempData;
   }
   ++outDataIndex;
 
-  _dataOut[0][outDataIndex] = 1;
+  writeTempData = quantity;
 #if USE_CRC
-  calculate_crc(_dataOut[0][outDataIndex]);
+  calculate_crc(&crc.value, writeTempData);
 #endif
+  if (writeTempData == START_FLAG || writeTempData == END_FLAG || writeTempData == ESCAPE_FLAG) {
+    ctx->dataOut[0][outDataIndex] = ESCAPE_FLAG;
+    ++outDataIndex;
+    ctx->dataOut[0][outDataIndex] = writeTempData ^ XOR_FLAG;
+  } else {
+    ctx->dataOut[0][outDataIndex] = writeTempData;
+  }
   ++outDataIndex;
 
 #if USE_CRC
 
-  if ((_crc.byte.high == (uint8_t)START_FLAG) || (_crc.byte.high == (uint8_t)END_FLAG)
-      || (_crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[0][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.high == (uint8_t)START_FLAG) || (crc.byte.high == (uint8_t)END_FLAG)
+      || (crc.byte.high == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[0][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[0][outDataIndex] = _crc.byte.high ^ XOR_FLAG;
+    ctx->dataOut[0][outDataIndex] = crc.byte.high ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[0][outDataIndex] = _crc.byte.high;
+    ctx->dataOut[0][outDataIndex] = crc.byte.high;
     ++outDataIndex;
   }
 
-  if ((_crc.byte.low == (uint8_t)START_FLAG) || (_crc.byte.low == (uint8_t)END_FLAG)
-      || (_crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
-    _dataOut[0][outDataIndex] = ESCAPE_FLAG;
+  if ((crc.byte.low == (uint8_t)START_FLAG) || (crc.byte.low == (uint8_t)END_FLAG)
+      || (crc.byte.low == (uint8_t)ESCAPE_FLAG)) {
+    ctx->dataOut[0][outDataIndex] = ESCAPE_FLAG;
     ++outDataIndex;
-    _dataOut[0][outDataIndex] = _crc.byte.low ^ XOR_FLAG;
+    ctx->dataOut[0][outDataIndex] = crc.byte.low ^ XOR_FLAG;
     ++outDataIndex;
   } else {
-    _dataOut[0][outDataIndex] = _crc.byte.low;
+    ctx->dataOut[0][outDataIndex] = crc.byte.low;
     ++outDataIndex;
   }
 
 #endif
 
-  _dataOut[0][outDataIndex] = END_FLAG;
+  ctx->dataOut[0][outDataIndex] = END_FLAG;
   ++outDataIndex;
 
-  lumen_write_bytes(_dataOut[0], outDataIndex);
+#if USE_BATCH
+  lumen_batch_flush(ctx);
+#endif
+  return lumen_transmit(ctx, ctx->dataOut[0], outDataIndex);
+}
 
+bool lumen_ctx_request(lumen_ctx_t *ctx, lumen_packet_t *packet) {
+  return lumen_send_read(ctx, packet->address, 1);
+}
+
+bool lumen_ctx_request_multiple(lumen_ctx_t *ctx, uint16_t address, uint8_t quantity) {
+  return lumen_send_read(ctx, address, quantity);
+}
+
+// Sends one READ per run of consecutive addresses among packets, so the HMI
+// is never asked for a variable nobody waits for. False if the addresses are
+// more than 255 apart (nothing sent) or a frame did not fit the TX queue.
+static bool lumen_send_read_runs(lumen_ctx_t *ctx, const lumen_packet_t *packets, uint8_t quantity) {
+  uint16_t firstAddress = packets[0].address;
+  uint16_t lastAddress = packets[0].address;
+  for (uint8_t i = 1; i < quantity; ++i) {
+    if (packets[i].address < firstAddress) {
+      firstAddress = packets[i].address;
+    }
+    if (packets[i].address > lastAddress) {
+      lastAddress = packets[i].address;
+    }
+  }
+  if ((lastAddress - firstAddress) > 0xFF) {
+    return false;
+  }
+
+  // Bit n: firstAddress + n is wanted.
+  uint32_t wanted[8] = { 0 };
+  for (uint8_t i = 0; i < quantity; ++i) {
+    uint16_t n = packets[i].address - firstAddress;
+    wanted[n >> 5] |= 1UL << (n & 31);
+  }
+
+  uint16_t span = lastAddress - firstAddress + 1;
+  uint16_t n = 0;
+  while (n < span) {
+    if (!(wanted[n >> 5] & (1UL << (n & 31)))) {
+      ++n;
+      continue;
+    }
+    uint16_t start = n;
+    while (n < span && (wanted[n >> 5] & (1UL << (n & 31))) && (n - start) < 0xFF) {
+      ++n;
+    }
+    if (!lumen_send_read(ctx, firstAddress + start, (uint8_t)(n - start))) {
+      return false;
+    }
+  }
   return true;
 }
 
-bool lumen_read(lumen_packet_t *packet) {
+#if USE_ASYNC_REQUEST
+bool lumen_ctx_request_async(lumen_ctx_t *ctx, lumen_packet_t *packet, uint32_t timeout_in_ms, lumen_request_fn_t callback, void *user) {
+  uint8_t i = 0;
+  while (i < ASYNC_REQUESTS && (ctx->asyncPending & (1UL << i))) {
+    ++i;
+  }
+  if (i == ASYNC_REQUESTS) {
+    return false;
+  }
+
+  lumen_async_request_t *request = &ctx->asyncRequests[i];
+  request->packet = packet;
+  request->callback = callback;
+  request->user = user;
+  request->elapsedTime = 0;
+  request->timeout = timeout_in_ms;
+  request->fallback = false;
+
+  if (!lumen_send_read(ctx, packet->address, 1)) {
+    return false;
+  }
+  ctx->asyncPending |= 1UL << i;
+  return true;
+}
+
+bool lumen_ctx_request_multiple_async(lumen_ctx_t *ctx, lumen_packet_t *packets, uint8_t quantity, uint32_t timeout_in_ms,
+                                      lumen_request_fn_t callback, void *user) {
+  if (quantity == 0 || quantity > ASYNC_REQUESTS - lumen_ctx_requests_pending(ctx)) {
+    return false;
+  }
+  if (!lumen_send_read_runs(ctx, packets, quantity)) {
+    return false;
+  }
+
+  uint8_t i = 0;
+  for (uint8_t p = 0; p < quantity; ++p) {
+    while (ctx->asyncPending & (1UL << i)) {
+      ++i;
+    }
+    lumen_async_request_t *request = &ctx->asyncRequests[i];
+    request->packet = &packets[p];
+    request->callback = callback;
+    request->user = user;
+    request->elapsedTime = 0;
+    request->timeout = timeout_in_ms;
+    request->fallback = true;
+    ctx->asyncPending |= 1UL << i;
+  }
+  return true;
+}
+
+void lumen_ctx_request_tick(lumen_ctx_t *ctx, uint32_t time_in_ms) {
+
+#if USE_PROJECT_UPDATE
+  if (lumen_ctx_is_updating(ctx))
+    return;
+#endif
+
+  for (uint8_t i = 0; i < ASYNC_REQUESTS && ctx->asyncPending != 0; ++i) {
+    if (!(ctx->asyncPending & (1UL << i))) {
+      continue;
+    }
+    lumen_async_request_t *request = &ctx->asyncRequests[i];
+    request->elapsedTime += time_in_ms;
+    if (request->elapsedTime >= request->timeout && request->fallback) {
+      // Not in the multi-variable reply: ask for it alone, once.
+      request->fallback = false;
+      request->elapsedTime = 0;
+      lumen_send_read(ctx, request->packet->address, 1);
+    } else if (request->elapsedTime >= request->timeout) {
+      ctx->asyncPending &= ~(1UL << i);
+      if (request->callback) {
+        request->callback(request->packet, true, request->user);
+      }
+    }
+  }
+}
+
+uint8_t lumen_ctx_requests_pending(lumen_ctx_t *ctx) {
+  uint8_t quantity = 0;
+  for (uint32_t pending = ctx->asyncPending; pending != 0; pending &= pending - 1) {
+    ++quantity;
+  }
+  return quantity;
+}
+#endif
+
+bool lumen_ctx_read_multiple(lumen_ctx_t *ctx, lumen_packet_t *packets, uint8_t quantity) {
 
 #if USE_PROJECT_UPDATE
-  if (g_is_updating)
+  if (lumen_ctx_is_updating(ctx))
     return false;
 #endif
 
-  reading = true;
+  if (quantity == 0 || quantity > kReadMultipleMax) {
+    return false;
+  }
 
-  if (!lumen_request(packet)) {
+  ctx->readingPackets = packets;
+  ctx->readingQuantity = quantity;
+  ctx->readingPending = (quantity == 32) ? 0xFFFFFFFFUL : ((1UL << quantity) - 1);
+
+  if (!lumen_send_read_runs(ctx, packets, quantity)) {
+    ctx->readingPending = 0;
     return false;
   }
 
-  uint32_t elapsedTickTimeOut = 0;
+  // First the runs, then whatever they did not bring, one variable at a time.
+  for (uint8_t pass = 0; pass < 2; ++pass) {
+    if (pass == 1) {
+      for (uint8_t i = 0; i < quantity; ++i) {
+        if ((ctx->readingPending & (1UL << i)) && !lumen_send_read(ctx, packets[i].address, 1)) {
+          ctx->readingPending = 0;
+          return false;
+        }
+      }
+    }
+#if USE_TX_QUEUE
+    lumen_ctx_tx_flush(ctx);
+#endif
 
-  while (reading == true) {
-    lumen_available();
+    uint32_t elapsedTickTimeOut = 0;
 
-    ++elapsedTickTimeOut;
+    while (ctx->readingPending != 0 && elapsedTickTimeOut < TICK_TIME_OUT) {
+      lumen_ctx_available(ctx);
 
-    if (elapsedTickTimeOut >= TICK_TIME_OUT) {
-      return false;
+      ++elapsedTickTimeOut;
+    }
+    if (ctx->readingPending == 0) {
+      return true;
     }
   }
-  return true;
+  ctx->readingPending = 0;
+  return false;
+}
+
+bool lumen_ctx_read(lumen_ctx_t *ctx, lumen_packet_t *packet) {
+  return lumen_ctx_read_multiple(ctx, packet, 1);
+}
+
+void lumen_ctx_init(lumen_ctx_t *ctx, lumen_write_bytes_fn_t writeBytes, lumen_get_byte_fn_t getByte, void *user) {
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->writeBytes = writeBytes;
+  ctx->getByte = getByte;
+  ctx->getBytes = NULL;
+  ctx->user = user;
+  ctx->payloadIndex = kPayloadNull;
+#if USE_SCHEMA
+  memset(ctx->schema, kSchemaNone, sizeof(ctx->schema));
+#endif
+#if QUANTITY_OF_PACKETS > 0
+  ctx->packets = ctx->packetStorage;
+  ctx->packetsCapacity = QUANTITY_OF_PACKETS;
+#endif
+#if USE_ACK
+  ctx->dataOutIndex = 1;
+#endif
+#if USE_TX_QUEUE
+  ctx->txLanes[kLaneRealtime].data = ctx->txRealtimeData;
+  ctx->txLanes[kLaneRealtime].size = TX_REALTIME_QUEUE_SIZE;
+  ctx->txLanes[kLaneBulk].data = ctx->txBulkData;
+  ctx->txLanes[kLaneBulk].size = TX_QUEUE_SIZE;
+  ctx->txLane = kLaneRealtime;
+  ctx->txOpenFrameLane = kQuantityOfLanes;
+#endif
+}
+
+void lumen_ctx_set_packet_pool(lumen_ctx_t *ctx, lumen_packet_t *pool, uint16_t capacity) {
+  ctx->packets = pool;
+  ctx->packetsCapacity = (pool != NULL) ? capacity : 0;
+  ctx->packetsHead = 0;
+  ctx->packetsTail = 0;
+  ctx->quantityOfPacketsAvailable = 0;
+}
+
+void lumen_ctx_rx_errors(lumen_ctx_t *ctx, uint32_t *malformed, uint32_t *resyncs) {
+  if (malformed) {
+    *malformed = ctx->rxMalformed;
+  }
+  if (resyncs) {
+    *resyncs = ctx->rxResyncs;
+  }
+}
+
+void lumen_ctx_rx_stats(lumen_ctx_t *ctx, uint32_t *dropped, uint32_t *overruns, uint32_t *truncated, uint32_t *peak) {
+  if (dropped) {
+    *dropped = ctx->rxDropped;
+  }
+  if (overruns) {
+    *overruns = ctx->rxOverruns;
+  }
+  if (truncated) {
+    *truncated = ctx->rxTruncated;
+  }
+  if (peak) {
+    *peak = ctx->rxPeak;
+  }
+}
+
+static void lumen_default_write_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  lumen_write_bytes(data, length);
+}
+
+static uint16_t lumen_default_get_byte(void *user) {
+  (void)user;
+  return lumen_get_byte();
+}
+
+#if USE_BLOCK_READ
+static uint32_t lumen_default_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  (void)user;
+  return lumen_get_bytes(data, max);
+}
+#endif
+
+void lumen_ctx_set_get_bytes(lumen_ctx_t *ctx, lumen_get_bytes_fn_t getBytes) {
+  ctx->getBytes = getBytes;
+}
+
+lumen_ctx_t *lumen_default_ctx() {
+  if (!_defaultCtxReady) {
+    lumen_ctx_init(&_defaultCtx, lumen_default_write_bytes, lumen_default_get_byte, NULL);
+#if USE_BLOCK_READ
+    lumen_ctx_set_get_bytes(&_defaultCtx, lumen_default_get_bytes);
+#endif
+    _defaultCtxReady = true;
+  }
+  return &_defaultCtx;
+}
+
+uint32_t lumen_write(uint16_t address, uint8_t *data, uint32_t length) {
+  return lumen_ctx_write(lumen_default_ctx(), address, data, length);
+}
+
+uint32_t lumen_write_variable_list(uint16_t address, uint16_t index, uint8_t *data, uint32_t length) {
+  return lumen_ctx_write_variable_list(lumen_default_ctx(), address, index, data, length);
+}
+
+uint32_t lumen_write_packet(lumen_packet_t *packet) {
+  return lumen_ctx_write_packet(lumen_default_ctx(), packet);
+}
+
+#if !USE_ACK
+uint32_t lumen_write_encoded(uint16_t address, uint32_t payloadHash, uint32_t payloadLength, const uint8_t *frame,
+                             uint32_t length) {
+  return lumen_ctx_write_encoded(lumen_default_ctx(), address, payloadHash, payloadLength, frame, length);
+}
+#endif
+
+uint32_t lumen_available() {
+  return lumen_ctx_available(lumen_default_ctx());
+}
+
+bool lumen_read(lumen_packet_t *packet) {
+  return lumen_ctx_read(lumen_default_ctx(), packet);
+}
+
+bool lumen_request(lumen_packet_t *packet) {
+  return lumen_ctx_request(lumen_default_ctx(), packet);
+}
+
+bool lumen_request_multiple(uint16_t address, uint8_t quantity) {
+  return lumen_ctx_request_multiple(lumen_default_ctx(), address, quantity);
+}
+
+bool lumen_read_multiple(lumen_packet_t *packets, uint8_t quantity) {
+  return lumen_ctx_read_multiple(lumen_default_ctx(), packets, quantity);
+}
+
+lumen_packet_t *lumen_get_first_packet() {
+  return lumen_ctx_get_first_packet(lumen_default_ctx());
+}
+
+#if USE_ASYNC_REQUEST
+bool lumen_request_async(lumen_packet_t *packet, uint32_t timeout_in_ms, lumen_request_fn_t callback, void *user) {
+  return lumen_ctx_request_async(lumen_default_ctx(), packet, timeout_in_ms, callback, user);
+}
+
+bool lumen_request_multiple_async(lumen_packet_t *packets, uint8_t quantity, uint32_t timeout_in_ms,
+                                  lumen_request_fn_t callback, void *user) {
+  return lumen_ctx_request_multiple_async(lumen_default_ctx(), packets, quantity, timeout_in_ms, callback, user);
+}
+
+void lumen_request_tick(uint32_t time_in_ms) {
+  lumen_ctx_request_tick(lumen_default_ctx(), time_in_ms);
+}
+
+uint8_t lumen_requests_pending() {
+  return lumen_ctx_requests_pending(lumen_default_ctx());
+}
+#endif
+
+void lumen_set_packet_pool(lumen_packet_t *pool, uint16_t capacity) {
+  lumen_ctx_set_packet_pool(lumen_default_ctx(), pool, capacity);
+}
+
+void lumen_rx_stats(uint32_t *dropped, uint32_t *overruns, uint32_t *truncated, uint32_t *peak) {
+  lumen_ctx_rx_stats(lumen_default_ctx(), dropped, overruns, truncated, peak);
+}
+
+void lumen_rx_errors(uint32_t *malformed, uint32_t *resyncs) {
+  lumen_ctx_rx_errors(lumen_default_ctx(), malformed, resyncs);
+}
+
+#if USE_BATCH
+void lumen_batch_begin() {
+  lumen_ctx_batch_begin(lumen_default_ctx());
+}
+
+uint32_t lumen_batch_append(lumen_packet_t *packet) {
+  return lumen_ctx_batch_append(lumen_default_ctx(), packet);
+}
+
+bool lumen_batch_commit() {
+  return lumen_ctx_batch_commit(lumen_default_ctx());
+}
+#endif
+
+#if USE_TX_QUEUE
+lumen_tx_lane_t lumen_tx_select_lane(lumen_tx_lane_t lane) {
+  return lumen_ctx_tx_select_lane(lumen_default_ctx(), lane);
+}
+
+uint32_t lumen_tx_drain(uint32_t budget) {
+  return lumen_ctx_tx_drain(lumen_default_ctx(), budget);
 }
 
+void lumen_tx_flush() {
+  lumen_ctx_tx_flush(lumen_default_ctx());
+}
+
+uint32_t lumen_tx_pending() {
+  return lumen_ctx_tx_pending(lumen_default_ctx());
+}
+
+void lumen_tx_stats(lumen_tx_lane_t lane, uint32_t *peak, uint32_t *rejected) {
+  lumen_ctx_tx_stats(lumen_default_ctx(), lane, peak, rejected);
+}
+#endif
+
+#if USE_COALESCE
+bool lumen_coalesce(uint16_t firstAddress, uint16_t lastAddress) {
+  return lumen_ctx_coalesce(lumen_default_ctx(), firstAddress, lastAddress);
+}
+
+void lumen_coalesce_clear() {
+  lumen_ctx_coalesce_clear(lumen_default_ctx());
+}
+#endif
+
+#if USE_DISPATCH
+bool lumen_on(uint16_t address, lumen_handler_fn_t handler, void *user) {
+  return lumen_ctx_on(lumen_default_ctx(), address, handler, user);
+}
+
+bool lumen_on_range(uint16_t firstAddress, uint16_t lastAddress, lumen_handler_fn_t handler, void *user) {
+  return lumen_ctx_on_range(lumen_default_ctx(), firstAddress, lastAddress, handler, user);
+}
+
+bool lumen_dispatch(lumen_packet_t *packet) {
+  return lumen_ctx_dispatch(lumen_default_ctx(), packet);
+}
+#endif
+
+#if USE_SCHEMA
+bool lumen_set_schema(const lumen_variable_t *variables, uint16_t quantity) {
+  return lumen_ctx_set_schema(lumen_default_ctx(), variables, quantity);
+}
+
+void lumen_schema_stats(uint32_t *typed, uint32_t *mistyped) {
+  lumen_ctx_schema_stats(lumen_default_ctx(), typed, mistyped);
+}
+#endif
+
+#if USE_SHADOW
+void lumen_shadow_invalidate(uint16_t address) {
+  lumen_ctx_shadow_invalidate(lumen_default_ctx(), address);
+}
+
+void lumen_shadow_invalidate_all() {
+  lumen_ctx_shadow_invalidate_all(lumen_default_ctx());
+}
+
+void lumen_shadow_stats(uint32_t *hits, uint32_t *misses) {
+  lumen_ctx_shadow_stats(lumen_default_ctx(), hits, misses);
+}
+#endif
+
+#if USE_ACK
+void lumen_ack_trigger(uint32_t time_in_ms) {
+  lumen_ctx_ack_trigger(lumen_default_ctx(), time_in_ms);
+}
+#endif
+
 #if USE_PROJECT_UPDATE
 
 #define MESSAGE(x) lumen_write_bytes((uint8_t *)x, (uint32_t)sizeof(x) - 1)
@@ -849,6 +1934,30 @@ lumen_project_update_word_packet_t notOkMessageWordComparator = { .word = kNotOK
 
 uint32_t elapsedTimeInMs = 0;
 bool isStarted = false;
+static uint16_t receivedData;
+
+#if USE_BLOCK_READ
+static uint8_t updateRxBuffer[RX_BLOCK_SIZE];
+static uint32_t updateRxLength = 0;
+static uint32_t updateRxIndex = 0;
+#endif
+
+// Handshake input, taken a block at a time from lumen_get_bytes when it is
+// available. Bytes left in the block stay there for the next call.
+static uint16_t lumen_project_update_get_byte() {
+#if USE_BLOCK_READ
+  if (updateRxIndex >= updateRxLength) {
+    updateRxLength = lumen_get_bytes(updateRxBuffer, sizeof(updateRxBuffer));
+    updateRxIndex = 0;
+    if (updateRxLength == 0) {
+      return DATA_NULL;
+    }
+  }
+  return updateRxBuffer[updateRxIndex++];
+#else
+  return lumen_get_byte();
+#endif
+}
 
 static bool lumen_project_update_word_checker(lumen_project_update_word_packet_t *word_packet, char character) {
   if (word_packet->word[word_packet->index] == character) {
@@ -870,28 +1979,8 @@ static bool lumen_project_update_word_checker(lumen_project_update_word_packet_t
 static u16_union_t lumen_project_update_calculate_crc(uint8_t *data, uint32_t length) {
 
   static u16_union_t crc;
-  static uint32_t pos;
-  static uint32_t i;
-  static uint32_t z = 0;
-  static uint32_t u = 0x0001;
-  static uint32_t o = 8;
-  static uint32_t p = 0xA001;
 
-  crc.value = 0xFFFF;
-
-  for (pos = z; pos < length; pos++) {
-    crc.value ^= (uint16_t)*data;
-    ++data;
-
-    for (i = o; z != i; --i) {
-      if (z != (u & crc.value)) {
-        crc.value >>= u;
-        crc.value ^= p;
-      } else {
-        crc.value >>= u;
-      }
-    }
-  }
+  crc.value = lumen_crc16(0xFFFF, data, length);
   return crc;
 }
 
@@ -902,13 +1991,13 @@ static bool lumen_project_update_start() {
   }
 
   static uint32_t startInterval = kStartInterval;
-  receivedData = lumen_get_byte();
+  receivedData = lumen_project_update_get_byte();
 
   while (receivedData != 0xFFFF) {
     if (lumen_project_update_word_checker(&okMessageWordComparator, (char)receivedData)) {
       isStarted = true;
     }
-    receivedData = lumen_get_byte();
+    receivedData = lumen_project_update_get_byte();
   }
 
   if (elapsedTimeInMs >= startInterval) {
@@ -920,6 +2009,11 @@ static bool lumen_project_update_start() {
 }
 
 bool lumen_project_update_send_data(uint8_t *data, uint32_t length) {
+#if USE_TX_QUEUE
+  if (!g_is_updating) {
+    lumen_tx_flush();
+  }
+#endif
   g_is_updating = true;
 
   if (lumen_project_update_start()) {
@@ -981,7 +2075,7 @@ bool lumen_project_update_send_data(uint8_t *data, uint32_t length) {
           break;
         case kWaitingForOkMessageOfNewBlockCmd:
           {
-            receivedData = lumen_get_byte();
+            receivedData = lumen_project_update_get_byte();
             while (receivedData != 0xFFFF) {
               if (lumen_project_update_word_checker(&okMessageWordComparator, (char)receivedData)) {
                 lumen_write_bytes(blockBuffer, kProjectUpdateBlockLength + kProjectUpdateCrcLength);
@@ -994,13 +2088,13 @@ bool lumen_project_update_send_data(uint8_t *data, uint32_t length) {
                 sendBlockInterval = kSendBlockInterval + elapsedTimeInMs;
                 break;
               }
-              receivedData = lumen_get_byte();
+              receivedData = lumen_project_update_get_byte();
             }
           }
           break;
         case kWaitingForOkMessageOfBlock:
           {
-            receivedData = lumen_get_byte();
+            receivedData = lumen_project_update_get_byte();
             while (receivedData != 0xFFFF) {
               if (lumen_project_update_word_checker(&okMessageWordComparator, (char)receivedData)) {
                 sending = false;
@@ -1014,7 +2108,7 @@ bool lumen_project_update_send_data(uint8_t *data, uint32_t length) {
                 sendBlockInterval = kSendBlockInterval + elapsedTimeInMs;
                 break;
               }
-              receivedData = lumen_get_byte();
+              receivedData = lumen_project_update_get_byte();
             }
           }
           break;
@@ -1046,6 +2140,10 @@ void lumen_project_update_finish() {
   g_is_updating = false;
   MESSAGE(kCommandFinished);
   isStarted = false;
+#if USE_BLOCK_READ
+  updateRxLength = 0;
+  updateRxIndex = 0;
+#endif
 }
 
 #endif
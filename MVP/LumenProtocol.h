@@ -14,6 +14,7 @@ extern "C" {
 #include "LumenProtocolConfiguration.h"
 
 #define DATA_NULL 0xFFFF
+#define LUMEN_DATA_LENGTH ((MAX_STRING_SIZE + 8) * 2)
 
   typedef union {
     bool _bool;
@@ -49,13 +50,451 @@ extern "C" {
     lumen_data_t data;
   } lumen_packet_t;
 
+  typedef enum {
+    kLaneRealtime,
+    kLaneBulk,
+    kQuantityOfLanes
+  } lumen_tx_lane_t;
+
+#if USE_TX_QUEUE
+  typedef struct {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t pending;
+    uint32_t peak;
+    uint32_t rejected;
+  } lumen_tx_ring_t;
+#endif
+
+#if USE_SHADOW
+  typedef struct {
+    uint16_t address;
+    bool valid;
+    uint16_t length;  // of the payload, so equal hashes of different sizes never match
+    uint32_t hash;
+  } lumen_shadow_entry_t;
+#endif
+
+  typedef struct {
+    uint16_t first;
+    uint16_t last;
+  } lumen_address_range_t;
+
+  typedef void (*lumen_handler_fn_t)(lumen_packet_t *packet, void *user);
+
+#if USE_DISPATCH
+  typedef struct {
+    lumen_handler_fn_t handler;
+    void *user;
+  } lumen_handler_t;
+#endif
+
+  typedef struct {
+    uint16_t address;
+    lumen_data_type_t type;
+  } lumen_variable_t;
+
+  typedef void (*lumen_request_fn_t)(lumen_packet_t *packet, bool timedOut, void *user);
+
+#if USE_ASYNC_REQUEST
+  typedef struct {
+    lumen_packet_t *packet;
+    lumen_request_fn_t callback;
+    void *user;
+    uint32_t elapsedTime;
+    uint32_t timeout;
+    bool fallback;  // part of a multi-variable read: asked again alone before timing out
+  } lumen_async_request_t;
+#endif
+
+  typedef void (*lumen_write_bytes_fn_t)(void *user, uint8_t *data, uint32_t length);
+  typedef uint16_t (*lumen_get_byte_fn_t)(void *user);
+  // Copies up to max bytes that already arrived into data and returns how
+  // many; 0 when there are none. Must not block.
+  typedef uint32_t (*lumen_get_bytes_fn_t)(void *user, uint8_t *data, uint32_t max);
+
+  // State of one HMI link. The fields are private to LumenProtocol.c; the
+  // struct is public only so instances can be allocated statically.
+  typedef struct {
+    lumen_write_bytes_fn_t writeBytes;
+    lumen_get_byte_fn_t getByte;
+    lumen_get_bytes_fn_t getBytes;
+    void *user;
+
+    // Received packets in arrival order: taken from packetsTail, added at
+    // packetsHead. packets is packetStorage unless a pool was set.
+#if QUANTITY_OF_PACKETS > 0
+    lumen_packet_t packetStorage[QUANTITY_OF_PACKETS];
+#endif
+    lumen_packet_t *packets;
+    uint16_t packetsCapacity;
+    uint16_t packetsHead;
+    uint16_t packetsTail;
+    uint16_t quantityOfPacketsAvailable;
+    uint32_t rxDropped;
+    uint32_t rxOverruns;
+    uint32_t rxTruncated;
+    uint32_t rxPeak;
+    uint32_t rxMalformed;
+    uint32_t rxResyncs;
+#if USE_COALESCE
+    lumen_address_range_t coalesce[COALESCE_RANGES];
+    uint8_t quantityOfCoalesceRanges;
+#endif
+#if USE_DISPATCH
+    // Indexed by address - DISPATCH_FIRST_ADDRESS.
+    lumen_handler_t handlers[DISPATCH_SIZE];
+#endif
+#if USE_SCHEMA
+    // lumen_data_type_t indexed by address - SCHEMA_FIRST_ADDRESS, 0xFF if unset.
+    uint8_t schema[SCHEMA_SIZE];
+    uint32_t schemaTyped;
+    uint32_t schemaMistyped;
+#endif
+
+    uint8_t dataIn[LUMEN_DATA_LENGTH];
+    uint32_t dataIndex;
+    uint16_t receivedData;
+    uint32_t command;
+    uint16_t address;
+    uint8_t payloadIndex;
+    bool started;
+    bool escaped;
+    bool overrun;
+#if USE_CRC
+    uint16_t rxCrc;
+    uint32_t crcIndexDelayed;
+#endif
+
+    lumen_packet_t *readingPackets;
+    uint8_t readingQuantity;
+    uint32_t readingPending;
+#if USE_ASYNC_REQUEST
+    lumen_async_request_t asyncRequests[ASYNC_REQUESTS];
+    // Bit i set while asyncRequests[i] waits for its reply.
+    uint32_t asyncPending;
+#endif
+
+    uint8_t dataOut[QUANTITY_OF_DATABUFFER_FOR_RETRY][LUMEN_DATA_LENGTH];
+    uint8_t dataOutIndex;
+#if USE_ACK
+    uint32_t dataOutElapsedTime[QUANTITY_OF_DATABUFFER_FOR_RETRY];
+    uint8_t dataOutRetries[QUANTITY_OF_DATABUFFER_FOR_RETRY];
+    uint8_t dataOutLengths[QUANTITY_OF_DATABUFFER_FOR_RETRY];
+#endif
+
+#if USE_BATCH
+    uint8_t batchOut[BATCH_BUFFER_SIZE];
+    uint32_t batchLength;
+    uint8_t batchDepth;
+    bool batchFailed;  // frames of the open batch were dropped
+#endif
+
+#if USE_SHADOW
+    lumen_shadow_entry_t shadow[SHADOW_SIZE];
+    uint32_t shadowHits;
+    uint32_t shadowMisses;
+#endif
+
+#if USE_TX_QUEUE
+    uint8_t txRealtimeData[TX_REALTIME_QUEUE_SIZE];
+    uint8_t txBulkData[TX_QUEUE_SIZE];
+    lumen_tx_ring_t txLanes[kQuantityOfLanes];
+    lumen_tx_lane_t txLane;
+    // Lane whose frame was cut short by the drain budget, kQuantityOfLanes if none.
+    lumen_tx_lane_t txOpenFrameLane;
+#endif
+  } lumen_ctx_t;
+
+  // Every lumen_ctx_* function works on its own context, so one sketch can
+  // drive several displays. The functions without a ctx argument use the
+  // default context, which talks through lumen_write_bytes / lumen_get_byte
+  // (and lumen_get_bytes with USE_BLOCK_READ).
+  // A project update only ever runs on the default context.
+  void lumen_ctx_init(lumen_ctx_t *ctx, lumen_write_bytes_fn_t writeBytes, lumen_get_byte_fn_t getByte, void *user);
+  // With a block reader set, input is decoded a whole span per call and
+  // getByte is no longer used. Pass NULL to go back to getByte.
+  void lumen_ctx_set_get_bytes(lumen_ctx_t *ctx, lumen_get_bytes_fn_t getBytes);
+  lumen_ctx_t *lumen_default_ctx();
+
+  uint32_t lumen_ctx_write(lumen_ctx_t *ctx, uint16_t address, uint8_t *data, uint32_t length);
+  uint32_t lumen_ctx_write_variable_list(lumen_ctx_t *ctx, uint16_t address, uint16_t index, uint8_t *data, uint32_t length);
+  uint32_t lumen_ctx_write_packet(lumen_ctx_t *ctx, lumen_packet_t *packet);
+#if !USE_ACK
+  uint32_t lumen_ctx_write_encoded(lumen_ctx_t *ctx, uint16_t address, uint32_t payloadHash, uint32_t payloadLength,
+                                   const uint8_t *frame, uint32_t length);
+#endif
+  uint32_t lumen_ctx_available(lumen_ctx_t *ctx);
+  bool lumen_ctx_read(lumen_ctx_t *ctx, lumen_packet_t *packet);
+  bool lumen_ctx_request(lumen_ctx_t *ctx, lumen_packet_t *packet);
+  bool lumen_ctx_request_multiple(lumen_ctx_t *ctx, uint16_t address, uint8_t quantity);
+  bool lumen_ctx_read_multiple(lumen_ctx_t *ctx, lumen_packet_t *packets, uint8_t quantity);
+  lumen_packet_t *lumen_ctx_get_first_packet(lumen_ctx_t *ctx);
+#if USE_ASYNC_REQUEST
+  bool lumen_ctx_request_async(lumen_ctx_t *ctx, lumen_packet_t *packet, uint32_t timeout_in_ms, lumen_request_fn_t callback, void *user);
+  bool lumen_ctx_request_multiple_async(lumen_ctx_t *ctx, lumen_packet_t *packets, uint8_t quantity, uint32_t timeout_in_ms,
+                                        lumen_request_fn_t callback, void *user);
+  void lumen_ctx_request_tick(lumen_ctx_t *ctx, uint32_t time_in_ms);
+  uint8_t lumen_ctx_requests_pending(lumen_ctx_t *ctx);
+#endif
+  void lumen_ctx_set_packet_pool(lumen_ctx_t *ctx, lumen_packet_t *pool, uint16_t capacity);
+  void lumen_ctx_rx_stats(lumen_ctx_t *ctx, uint32_t *dropped, uint32_t *overruns, uint32_t *truncated, uint32_t *peak);
+  void lumen_ctx_rx_errors(lumen_ctx_t *ctx, uint32_t *malformed, uint32_t *resyncs);
+#if USE_BATCH
+  void lumen_ctx_batch_begin(lumen_ctx_t *ctx);
+  uint32_t lumen_ctx_batch_append(lumen_ctx_t *ctx, lumen_packet_t *packet);
+  bool lumen_ctx_batch_commit(lumen_ctx_t *ctx);
+#endif
+#if USE_TX_QUEUE
+  lumen_tx_lane_t lumen_ctx_tx_select_lane(lumen_ctx_t *ctx, lumen_tx_lane_t lane);
+  uint32_t lumen_ctx_tx_drain(lumen_ctx_t *ctx, uint32_t budget);
+  void lumen_ctx_tx_flush(lumen_ctx_t *ctx);
+  uint32_t lumen_ctx_tx_pending(lumen_ctx_t *ctx);
+  void lumen_ctx_tx_stats(lumen_ctx_t *ctx, lumen_tx_lane_t lane, uint32_t *peak, uint32_t *rejected);
+#endif
+#if USE_COALESCE
+  bool lumen_ctx_coalesce(lumen_ctx_t *ctx, uint16_t firstAddress, uint16_t lastAddress);
+  void lumen_ctx_coalesce_clear(lumen_ctx_t *ctx);
+#endif
+#if USE_DISPATCH
+  bool lumen_ctx_on(lumen_ctx_t *ctx, uint16_t address, lumen_handler_fn_t handler, void *user);
+  bool lumen_ctx_on_range(lumen_ctx_t *ctx, uint16_t firstAddress, uint16_t lastAddress, lumen_handler_fn_t handler, void *user);
+  bool lumen_ctx_dispatch(lumen_ctx_t *ctx, lumen_packet_t *packet);
+#endif
+#if USE_SCHEMA
+  bool lumen_ctx_set_schema(lumen_ctx_t *ctx, const lumen_variable_t *variables, uint16_t quantity);
+  void lumen_ctx_schema_stats(lumen_ctx_t *ctx, uint32_t *typed, uint32_t *mistyped);
+#endif
+#if USE_SHADOW
+  void lumen_ctx_shadow_invalidate(lumen_ctx_t *ctx, uint16_t address);
+  void lumen_ctx_shadow_invalidate_all(lumen_ctx_t *ctx);
+  void lumen_ctx_shadow_stats(lumen_ctx_t *ctx, uint32_t *hits, uint32_t *misses);
+#endif
+#if USE_ACK
+  void lumen_ctx_ack_trigger(lumen_ctx_t *ctx, uint32_t time_in_ms);
+#endif
+
   uint32_t lumen_write(uint16_t address, uint8_t *data, uint32_t length);
   uint32_t lumen_write_variable_list(uint16_t address, uint16_t index, uint8_t *data, uint32_t length);
   uint32_t lumen_write_packet(lumen_packet_t *packet);
+#if !USE_ACK
+  // Sends a complete frame encoded ahead of time for address (see
+  // host/gen_hmi_frames.cpp). payloadHash is lumen_shadow_hash of its payload
+  // and payloadLength its size, before escaping.
+  uint32_t lumen_write_encoded(uint16_t address, uint32_t payloadHash, uint32_t payloadLength, const uint8_t *frame,
+                               uint32_t length);
+#endif
   uint32_t lumen_available();
   bool lumen_read(lumen_packet_t *packet);
   bool lumen_request(lumen_packet_t *packet);
+  bool lumen_request_multiple(uint16_t address, uint8_t quantity);
+  // Reads every packets[i].address (at most 255 addresses apart, up to 32
+  // packets) with one READ per run of consecutive addresses, its quantity byte
+  // set to the run's length. Nothing outside the runs is asked for.
+  //
+  // How the HMI answers a READ for more than one variable is not documented
+  // in the vendor template: it declares kReadMultipleVariables but never sends
+  // or parses it, and its parser takes a reply frame as one address and one
+  // value. So replies are matched by address, whatever their order, and every
+  // packet still unanswered after the first wait is read again on its own,
+  // with quantity 1 as lumen_request always sent. An HMI that answers only the
+  // first variable of a run costs extra round trips, never a wrong value.
+  bool lumen_read_multiple(lumen_packet_t *packets, uint8_t quantity);
+  // Returns the oldest received packet, or NULL. It stays valid until the
+  // next lumen_available call.
   lumen_packet_t *lumen_get_first_packet();
+#if USE_ASYNC_REQUEST
+  // Sends a READ for packet->address and returns at once. When the reply
+  // arrives, lumen_available copies it into packet and calls
+  // callback(packet, false, user). If timeout_in_ms of lumen_request_tick time
+  // passes first, it calls callback(packet, true, user) instead. packet must
+  // stay valid until then. The callback may write and start new requests but
+  // must not call lumen_available. Returns false when all ASYNC_REQUESTS are
+  // in flight.
+  bool lumen_request_async(lumen_packet_t *packet, uint32_t timeout_in_ms, lumen_request_fn_t callback, void *user);
+  // lumen_read_multiple without waiting: one slot per packet, each completed
+  // through callback as above. A packet unanswered after timeout_in_ms is read
+  // again on its own and times out after another timeout_in_ms. Returns false,
+  // and sends nothing, when fewer than quantity slots are free.
+  bool lumen_request_multiple_async(lumen_packet_t *packets, uint8_t quantity, uint32_t timeout_in_ms,
+                                    lumen_request_fn_t callback, void *user);
+  void lumen_request_tick(uint32_t time_in_ms);
+  uint8_t lumen_requests_pending();
+#else
+  // Without USE_ASYNC_REQUEST no request is ever in flight.
+  static inline bool lumen_request_async(lumen_packet_t *packet, uint32_t timeout_in_ms, lumen_request_fn_t callback, void *user) {
+    (void)packet;
+    (void)timeout_in_ms;
+    (void)callback;
+    (void)user;
+    return false;
+  }
+  static inline bool lumen_request_multiple_async(lumen_packet_t *packets, uint8_t quantity, uint32_t timeout_in_ms,
+                                                  lumen_request_fn_t callback, void *user) {
+    (void)packets;
+    (void)quantity;
+    (void)timeout_in_ms;
+    (void)callback;
+    (void)user;
+    return false;
+  }
+  static inline void lumen_request_tick(uint32_t time_in_ms) {
+    (void)time_in_ms;
+  }
+  static inline uint8_t lumen_requests_pending() {
+    return 0;
+  }
+#endif
+  // Replaces the RX queue storage with capacity packets from pool and empties
+  // the queue. Call it right after boot; with QUANTITY_OF_PACKETS 0 it is the
+  // only storage there is.
+  void lumen_set_packet_pool(lumen_packet_t *pool, uint16_t capacity);
+  // dropped: packets lost to a full queue. overruns: frames longer than the
+  // input buffer, which are dropped. truncated: payloads cut to fit
+  // lumen_data_t. peak: most packets ever queued at once.
+  void lumen_rx_stats(uint32_t *dropped, uint32_t *overruns, uint32_t *truncated, uint32_t *peak);
+  // malformed: frames dropped at END_FLAG for a short header, a dangling
+  // escape, an unknown command or a bad CRC. resyncs: frames abandoned
+  // because a START_FLAG arrived before their END_FLAG.
+  void lumen_rx_errors(uint32_t *malformed, uint32_t *resyncs);
+
+#if USE_COALESCE
+  // A packet from an address in [firstAddress, lastAddress] that arrives while
+  // another from the same address is still queued overwrites it in place.
+  // Meant for continuous values such as sliders; leave command variables out
+  // so every event reaches the sketch. Returns false when all COALESCE_RANGES
+  // are taken.
+  bool lumen_coalesce(uint16_t firstAddress, uint16_t lastAddress);
+  void lumen_coalesce_clear();
+#else
+  // Without USE_COALESCE every packet takes its own RX slot.
+  static inline bool lumen_coalesce(uint16_t firstAddress, uint16_t lastAddress) {
+    (void)firstAddress;
+    (void)lastAddress;
+    return false;
+  }
+  static inline void lumen_coalesce_clear() {}
+#endif
+
+#if USE_DISPATCH
+  // Calls handler(packet, user) for every packet from address passed to
+  // lumen_dispatch. A NULL handler removes the registration. Returns false
+  // when address is outside the dispatch window.
+  bool lumen_on(uint16_t address, lumen_handler_fn_t handler, void *user);
+  bool lumen_on_range(uint16_t firstAddress, uint16_t lastAddress, lumen_handler_fn_t handler, void *user);
+  // Returns false when no handler is registered for packet->address.
+  bool lumen_dispatch(lumen_packet_t *packet);
+#endif
+  // There is no stand-in without USE_DISPATCH: a no-op would lose every event,
+  // so the sketch routes lumen_get_first_packet itself.
+
+#if USE_SCHEMA
+  // Describes the type of each address in variables. A queued packet from
+  // one of them has packet->type set; a numeric payload whose size does not
+  // match is dropped and counted as mistyped. Packets from other addresses
+  // are queued as kString, their raw payload. Returns false if an address is
+  // outside the schema window (the others are still set).
+  bool lumen_set_schema(const lumen_variable_t *variables, uint16_t quantity);
+  void lumen_schema_stats(uint32_t *typed, uint32_t *mistyped);
+#else
+  // Without USE_SCHEMA packet->type is not set on received packets.
+  static inline bool lumen_set_schema(const lumen_variable_t *variables, uint16_t quantity) {
+    (void)variables;
+    (void)quantity;
+    return false;
+  }
+  static inline void lumen_schema_stats(uint32_t *typed, uint32_t *mistyped) {
+    if (typed) {
+      *typed = 0;
+    }
+    if (mistyped) {
+      *mistyped = 0;
+    }
+  }
+#endif
+
+#if USE_BATCH
+  // Frames written while a batch is open, including plain lumen_write,
+  // lumen_write_variable_list and lumen_write_packet calls, go out in one
+  // lumen_write_bytes call on the outermost lumen_batch_commit. Commit returns
+  // false once any frame of the batch was dropped because the TX queue had no
+  // room; a nested commit only knows about the frames flushed so far.
+  void lumen_batch_begin();
+  uint32_t lumen_batch_append(lumen_packet_t *packet);
+  bool lumen_batch_commit();
+#else
+  // Without USE_BATCH every frame goes out on its own, as it is written.
+  static inline void lumen_batch_begin() {}
+  static inline uint32_t lumen_batch_append(lumen_packet_t *packet) {
+    return lumen_write_packet(packet);
+  }
+  // Each write already reported its own failure.
+  static inline bool lumen_batch_commit() {
+    return true;
+  }
+#endif
+
+#if USE_TX_QUEUE
+  // Frames are queued whole on the selected lane; a write that does not fit
+  // returns 0 and is counted as rejected. lumen_tx_drain sends at most budget
+  // bytes, real-time frames first, and never cuts into a frame already on the
+  // wire. lumen_tx_flush blocks until both lanes are empty.
+  lumen_tx_lane_t lumen_tx_select_lane(lumen_tx_lane_t lane);
+  uint32_t lumen_tx_drain(uint32_t budget);
+  void lumen_tx_flush();
+  uint32_t lumen_tx_pending();
+  void lumen_tx_stats(lumen_tx_lane_t lane, uint32_t *peak, uint32_t *rejected);
+#else
+  // Without USE_TX_QUEUE frames are written to the transport at once, in
+  // call order, so there is a single lane and nothing to drain.
+  static inline lumen_tx_lane_t lumen_tx_select_lane(lumen_tx_lane_t lane) {
+    (void)lane;
+    return kLaneRealtime;
+  }
+  static inline uint32_t lumen_tx_drain(uint32_t budget) {
+    (void)budget;
+    return 0;
+  }
+  static inline void lumen_tx_flush() {}
+  static inline uint32_t lumen_tx_pending() {
+    return 0;
+  }
+  static inline void lumen_tx_stats(lumen_tx_lane_t lane, uint32_t *peak, uint32_t *rejected) {
+    (void)lane;
+    if (peak) {
+      *peak = 0;
+    }
+    if (rejected) {
+      *rejected = 0;
+    }
+  }
+#endif
+
+#if USE_SHADOW
+  // A write suppressed because the HMI already shows that value still
+  // returns the payload length. Invalidate an address to force a resend, and
+  // everything once the HMI has restarted: it no longer shows what we wrote.
+  uint32_t lumen_shadow_hash(const uint8_t *data, uint32_t length);
+  void lumen_shadow_invalidate(uint16_t address);
+  void lumen_shadow_invalidate_all();
+  void lumen_shadow_stats(uint32_t *hits, uint32_t *misses);
+#else
+  // Without USE_SHADOW every write is sent, so there is nothing to forget.
+  static inline void lumen_shadow_invalidate(uint16_t address) {
+    (void)address;
+  }
+  static inline void lumen_shadow_invalidate_all() {}
+  static inline void lumen_shadow_stats(uint32_t *hits, uint32_t *misses) {
+    if (hits) {
+      *hits = 0;
+    }
+    if (misses) {
+      *misses = 0;
+    }
+  }
+#endif
 
 #if USE_ACK
   void lumen_ack_trigger(uint32_t time_in_ms);
@@ -4,6 +4,8 @@
 // Version 1.2
 
 #define MAX_STRING_SIZE 11
+// Capacity of the RX queue. Packets come out oldest first; when it is full
+// new ones are dropped. It can be 0 when lumen_set_packet_pool provides it.
 #define QUANTITY_OF_PACKETS 10
 
 #define TICK_TIME_OUT 0xFFFFFF
@@ -19,6 +21,98 @@
 #define QUANTITY_OF_DATABUFFER_FOR_RETRY 1
 #endif
 
+// The USE_* options below can also be set from the compiler command line
+// (-DUSE_BATCH=false). With one turned off, LumenProtocol.h keeps its calls
+// compiling as no-ops or plain writes.
+
+// Frames written between lumen_batch_begin and lumen_batch_commit are
+// collected here and sent with a single lumen_write_bytes call.
+#ifndef USE_BATCH
+#define USE_BATCH true
+#endif
+
+#if USE_BATCH
+#define BATCH_BUFFER_SIZE 512
+#endif
+
+// Keeps a hash of the last value written to each address and drops
+// lumen_write calls that would resend the same value.
+#ifndef USE_SHADOW
+#define USE_SHADOW true
+#endif
+
+#if USE_SHADOW
+#define SHADOW_SIZE 32
+#endif
+
+// Queues outgoing frames in a ring buffer instead of writing them straight to
+// the transport. Call lumen_tx_drain from loop() (or a TX-empty callback) to
+// move them out without blocking. Frames written on the real-time lane are
+// always sent ahead of those waiting on the bulk lane.
+#ifndef USE_TX_QUEUE
+#define USE_TX_QUEUE true
+#endif
+
+#if USE_TX_QUEUE
+#define TX_REALTIME_QUEUE_SIZE 256
+#define TX_QUEUE_SIZE 1024
+#endif
+
+// Packets from addresses registered with lumen_coalesce keep only their latest
+// value while queued, so a dragged slider takes one RX slot instead of all.
+#ifndef USE_COALESCE
+#define USE_COALESCE true
+#endif
+
+#if USE_COALESCE
+#define COALESCE_RANGES 4
+#endif
+
+// Handlers registered with lumen_on sit in a table indexed by
+// address - DISPATCH_FIRST_ADDRESS, so lumen_dispatch finds one in a single
+// lookup. Addresses outside the window cannot have a handler.
+#ifndef USE_DISPATCH
+#define USE_DISPATCH true
+#endif
+
+#if USE_DISPATCH
+#define DISPATCH_FIRST_ADDRESS 121
+#define DISPATCH_SIZE 64
+#endif
+
+// lumen_set_schema gives the type of each address in a table indexed by
+// address - SCHEMA_FIRST_ADDRESS. Received packets from those addresses carry
+// that type, and numeric payloads of the wrong size are dropped.
+#ifndef USE_SCHEMA
+#define USE_SCHEMA true
+#endif
+
+#if USE_SCHEMA
+#define SCHEMA_FIRST_ADDRESS 121
+#define SCHEMA_SIZE 64
+#endif
+
+// lumen_request_async sends a READ and returns at once; the reply is matched
+// by address inside lumen_available and handed to a callback. Up to
+// ASYNC_REQUESTS (at most 32) reads can be outstanding.
+#ifndef USE_ASYNC_REQUEST
+#define USE_ASYNC_REQUEST true
+#endif
+
+#if USE_ASYNC_REQUEST
+#define ASYNC_REQUESTS 12   // MVP.ino: 8 preset reads at boot, the screen read and its heartbeat
+#endif
+
+// lumen_available pulls input through lumen_get_bytes(data, max), a whole
+// span per call, instead of one lumen_get_byte call per byte. The sketch
+// must then define lumen_get_bytes as well.
+#ifndef USE_BLOCK_READ
+#define USE_BLOCK_READ true
+#endif
+
+// Bytes lumen_available asks a block reader for at a time (stack buffer).
+#define RX_BLOCK_SIZE 64
+
 /************************************************************ 
  * 
  * Attention! USE_PROJECT_UPDATE
@@ -1,12 +1,13 @@
 #include <Arduino.h>
 #include <FS.h>
 #include <SPIFFS.h>
-#include <limits.h>
 #include "LumenProtocol.h"
 
 #include "user_variables.h"
 #include "hmi_bindings.h"
 #include "hmi_renderer.h"
+#include "hmi_transport.h"
+#include "hmi_langpack.h"
 #include "smartcure_translations.h"
 
 //Config
@@ -17,16 +18,10 @@
 
 HardwareSerial HMIserial(2);
 
-// Transporte Lumen
-extern "C" void lumen_write_bytes(uint8_t *data, uint32_t length){ HMIserial.write(data, length); }
-extern "C" uint16_t lumen_get_byte(){ return HMIserial.available() ? HMIserial.read() : DATA_NULL; }
+// Transporte Lumen: lumen_write_bytes / lumen_get_bytes ficam em hmi_transport.cpp,
+// com os bytes recebidos num ring alimentado pelo evento de RX da UART
 
 // ====== Lógica de cura ======
-const uint16_t selected_pre_cureAddress = 138;
-const uint16_t time_curandoAddress      = 139;
-const uint16_t timer_start_stopAddress  = 140;
-const uint16_t progress_permilleAddress = 141; // extra para barra de progresso
-
 enum CureState { STATE_IDLE = 0, STATE_RUNNING = 1, STATE_PAUSED = 2 };
 static CureState cureState = STATE_IDLE;
 
@@ -40,11 +35,6 @@ static int32_t last_progress_reported = -1;
 
 static uint32_t pre_cure_values[7] = {6, 15, 30, 60, 90, 120, 180};
 
-static lumen_packet_t selected_pre_curePacket = { selected_pre_cureAddress, kS32 };
-static lumen_packet_t time_curandoPacket     = { time_curandoAddress,     kS32 };
-static lumen_packet_t timer_start_stopPacket = { timer_start_stopAddress, kS32 };
-static lumen_packet_t progress_permillePacket= { progress_permilleAddress,kS32 };
-
 static inline void writeInt(lumen_packet_t* packet, int32_t value){
   packet->type = kS32;
   packet->data._s32 = value;
@@ -85,15 +75,41 @@ static void stopCure(){
   writeInt(&timer_start_stopPacket, 0);
 }
 
+static void writePresets(){
+  writeInt(&pre_cure_1Packet, pre_cure_values[0]);
+  writeInt(&pre_cure_2Packet, pre_cure_values[1]);
+  writeInt(&pre_cure_3Packet, pre_cure_values[2]);
+  writeInt(&pre_cure_4Packet, pre_cure_values[3]);
+  writeInt(&pre_cure_5Packet, pre_cure_values[4]);
+  writeInt(&pre_cure_6Packet, pre_cure_values[5]);
+  writeInt(&pre_cure_7Packet, pre_cure_values[6]);
+  writeInt(&selected_pre_curePacket, target_time_s);
+}
+
+// Presets, preset selecionado e estado do timer, como o firmware os conhece (um único burst na UART)
+static void writeCureState(){
+  lumen_batch_begin();
+  writePresets();
+  if (cureState == STATE_IDLE){
+    stopCure();
+  } else {
+    writeInt(&time_curandoPacket, last_time_reported < 0 ? 0 : last_time_reported);
+    writeInt(&progress_permillePacket, last_progress_reported < 0 ? 0 : last_progress_reported);
+    writeInt(&timer_start_stopPacket, cureState == STATE_RUNNING ? 1 : 3);
+  }
+  lumen_batch_commit();
+}
+
 // Estado do idioma
 static Language currentLang = LANG_PT;
 
 // ==== Utilitários de idioma ====
+// Índice da var 123 / lista 126 = Language; depois dos embutidos vêm os idiomas de pacote
 static inline Language mapLangVar(int32_t v){
-  switch (v){ case 0: return LANG_EN; case 1: return LANG_PT; case 2: return LANG_ES; case 3: return LANG_DE; default: return LANG_EN; }
+  return (v >= 0 && v < LangPack_Count()) ? (Language)v : LANG_EN;
 }
 static inline int32_t unmapLangVar(Language L){
-  switch (L){ case LANG_PT: return 1; case LANG_ES: return 2; case LANG_DE: return 3; case LANG_EN: default: return 0; }
+  return (int32_t)L;
 }
 
 // ==== Persistência (config.json) ====
@@ -115,16 +131,18 @@ static int32_t parseLangIndexFromJson(const String& json){
   else if (q1a>=0){ q=q1a; qend=lower.indexOf('\'', q+1); }
   if (q<0 || qend<=q) return -1;
   String val = lower.substring(q+1, qend); val.trim();
-  if (val=="en") return 0; if (val=="pt") return 1; if (val=="es") return 2; if (val=="de") return 3;
-  return -1;
+  return LangPack_IndexOf(val.c_str());   // "en", "pt", ... ou o código de um pacote
 }
 
 // ==== Aplicar idioma + render ====
 static void applyLanguageIdx(int32_t idx, bool mirrorToHMI){
-  idx = constrain(idx, 0, 3);
+  idx = constrain(idx, 0, LangPack_Count() - 1);
   currentLang = mapLangVar(idx);
+  LangPack_Select((uint8_t)idx);                       // abre o pacote do idioma, se houver
+  lumen_batch_begin();
   if (mirrorToHMI) HMI_SyncLangVarToHMI(currentLang);  // espelha 123
-  HMI_RenderAll(currentLang);                          // atualiza tudo que estiver mapeado
+  HMI_RenderLanguage(currentLang);                     // a tela visível agora, as outras ao navegar
+  lumen_batch_commit();
   Serial.printf("[LANG] aplicado=%ld (espelhado=%s)\n", (long)idx, mirrorToHMI?"sim":"nao");
 }
 
@@ -137,66 +155,223 @@ static bool lumen_read_packet_compat(lumen_packet_t &out){
   return false;
 }
 
-// Extrator tolerante (funciona mesmo com type==0)
-static int32_t extractIndexLoose(const lumen_packet_t& p){
-  switch (p.type){
-    case kS32: return p.data._s32;
-    case kU32: return (int32_t)p.data._u32;
-    case kS16: return (int32_t)p.data._s16;
-    case kU16: return (int32_t)p.data._u16;
-    case kS8:  return (int32_t)p.data._s8;
-    case kU8:  return (int32_t)p.data._u8;
-    default: break;
+// Tipo vem do schema (HMI_SCHEMA), não precisa adivinhar
+static int32_t packetValue(const lumen_packet_t* p){
+#if USE_SCHEMA
+  switch (p->type){
+    case kS32: return p->data._s32;
+    case kU32: return (int32_t)p->data._u32;
+    case kS16: return (int32_t)p->data._s16;
+    case kU16: return (int32_t)p->data._u16;
+    case kS8:  return (int32_t)p->data._s8;
+    case kU8:  return (int32_t)p->data._u8;
+    default:   return 0;
+  }
+#else
+  return p->data._s32;   // sem schema o tipo não vem; as variáveis de evento são S32
+#endif
+}
+
+// ==== Handlers de eventos da HMI (registrados com lumen_on) ====
+static void onLanguage(lumen_packet_t* p, void* user){
+  (void)user;
+  bool mirror = (p->address == ADDR_LIST_LANG); // vindo da lista, espelha 123
+  applyLanguageIdx(packetValue(p), mirror);  // applyLanguageIdx limita aos idiomas disponíveis
+}
+
+static void onSelectedPreCure(lumen_packet_t* p, void* user){
+  (void)user;
+  int32_t value = packetValue(p);
+  target_time_s = (value > 0) ? (uint32_t)value : 0;
+  writeInt(&selected_pre_curePacket, target_time_s);
+}
+
+static void onTimerStartStop(lumen_packet_t* p, void* user){
+  (void)user;
+  int32_t value = packetValue(p);
+  if (value == 0){
+    stopCure();
+  } else if (value == 1 || value == 2){
+    if (cureState == STATE_IDLE) startCure();
+    else if (cureState == STATE_PAUSED) resumeCure();
+  } else if (value == 3){
+    pauseCure();
   }
-  int32_t cands[6] = {
-    p.data._s32, (int32_t)p.data._u32, (int32_t)p.data._s16,
-    (int32_t)p.data._u16, (int32_t)p.data._s8, (int32_t)p.data._u8
-  };
-  for (int i=0;i<6;i++){ if (cands[i] >= 0 && cands[i] <= 3) return cands[i]; }
-  const char* s = (const char*)p.data._string;
-  if (s && s[0]>='0' && s[0]<='9'){ int v = atoi(s); if (v>=0 && v<=3) return v; }
-  return INT32_MIN;
 }
 
+// Um handler para os 7 presets (130..136): o endereço dá o índice
+static void onPreCure(lumen_packet_t* p, void* user){
+  uint32_t* values = (uint32_t*)user;
+  int32_t value = packetValue(p);
+  if (value > 0) values[p->address - ADDR_PRE_CURE_1] = (uint32_t)value;
+}
+
+// Navegação: a tela nova recebe os textos que ficaram pendentes na troca de idioma
+static void onMainScreen(lumen_packet_t* p, void* user){
+  (void)user;
+  HMI_SetScreen(packetValue(p));
+}
+
+// ==== Presets no boot ====
+// A HMI pode ter ficado ligada enquanto o ESP reiniciava, com presets editados pelo
+// usuário. 130..136 e 138 são lidos numa leitura múltipla: valor > 0 é adotado, o
+// resto (HMI recém-ligada, sem resposta) recebe o default do firmware
+#define PRESET_READ_TIMEOUT_MS 300
+static lumen_packet_t presetReads[8];
+
+static void onPresetRead(lumen_packet_t* p, bool timedOut, void* user){
+  (void)user;
+  int32_t value = timedOut ? 0 : packetValue(p);
+  if (p->address == ADDR_SELECTED_PRE_CURE){
+    if (value > 0) target_time_s = (uint32_t)value;
+    else writeInt(&selected_pre_curePacket, target_time_s);
+    return;
+  }
+  uint32_t &preset = pre_cure_values[p->address - ADDR_PRE_CURE_1];
+  if (value > 0){
+    preset = (uint32_t)value;
+  } else {
+    lumen_packet_t out = { p->address, kS32 };
+    writeInt(&out, preset);
+  }
+}
+
+static void readPresets(){
+  for (uint8_t i = 0; i < 7; ++i) presetReads[i] = { (uint16_t)(ADDR_PRE_CURE_1 + i), kS32 };
+  presetReads[7] = { ADDR_SELECTED_PRE_CURE, kS32 };
+  if (!lumen_request_multiple_async(presetReads, 8, PRESET_READ_TIMEOUT_MS, onPresetRead, NULL)){
+    lumen_batch_begin();      // sem leitura assíncrona: os defaults, como antes
+    writePresets();
+    lumen_batch_commit();
+  }
+}
+
+// ==== Enlace com a HMI ====
+// A tela atual (121) é relida a cada HMI_HEARTBEAT_MS. HMI_LINK_MISSES leituras seguidas
+// sem resposta = HMI fora (reset, cabo). Quando volta, ela não mostra mais nada do que
+// foi escrito: o shadow ainda acharia que sim e pularia tudo, então é esquecido e o
+// estado inteiro é reenviado
+#define HMI_HEARTBEAT_MS          2000
+#define HMI_HEARTBEAT_TIMEOUT_MS  500
+#define HMI_LINK_MISSES           2
+static uint8_t hmiMisses = 0;
+
+// Início de sessão com a HMI (boot ou reconexão): nada do que ela mostra é conhecido
+static void beginHMISession(){
+  lumen_shadow_invalidate_all();
+  HMI_FillLanguageList();     // popula 126
+}
+
+static void resyncHMI(){
+  beginHMISession();
+  lumen_batch_begin();
+  HMI_SyncLangVarToHMI(currentLang);
+  HMI_RenderAll(currentLang);
+  lumen_batch_commit();
+  writeCureState();
+}
+
+// Resposta (ou timeout) da leitura assíncrona da tela atual: no boot e no heartbeat
+static void onMainScreenRead(lumen_packet_t* p, bool timedOut, void* user){
+  (void)user;
+  if (timedOut){
+    if (hmiMisses < HMI_LINK_MISSES && ++hmiMisses == HMI_LINK_MISSES){
+      Serial.println("[HMI] sem resposta: enlace perdido");
+    }
+    return;
+  }
+  if (hmiMisses >= HMI_LINK_MISSES){
+    Serial.println("[HMI] de volta: reenviando textos e estado");
+    resyncHMI();
+  }
+  hmiMisses = 0;
+  HMI_SetScreen(packetValue(p));
+}
+
+#if !USE_DISPATCH
+// Sem USE_DISPATCH não há tabela de handlers: o mesmo roteamento, por endereço
+static void dispatchPacket(lumen_packet_t* p){
+  if (p->address == ADDR_MAIN_SCREEN) onMainScreen(p, NULL);
+  else if (p->address == ADDR_LANG_VAR || p->address == ADDR_LIST_LANG) onLanguage(p, NULL);
+  else if (p->address == ADDR_SELECTED_PRE_CURE) onSelectedPreCure(p, NULL);
+  else if (p->address == ADDR_TIMER_START_STOP) onTimerStartStop(p, NULL);
+  else if (p->address >= ADDR_PRE_CURE_1 && p->address <= ADDR_PRE_CURE_7) onPreCure(p, pre_cure_values);
+}
+#endif
+
 // ==== Setup / Loop ====
 void setup(){
   Serial.begin(115200);
-  HMIserial.begin(HMI_BAUD, SERIAL_8N1, HMI_RX, HMI_TX);
+  HMI_TransportBegin(HMIserial, HMI_BAUD, HMI_RX, HMI_TX);
 
   if (!SPIFFS.begin(true)) Serial.println("SPIFFS mount falhou; seguindo com defaults.");
+  LangPack_Begin();           // idiomas em /lang/*.lpk
+
+  // Sliders de preset: só o último valor interessa. 140 (start/stop) fica de fora e mantém todos os eventos.
+  lumen_coalesce(ADDR_PRE_CURE_1, ADDR_PRE_CURE_7);
+
+  // Tipos das variáveis (user_variables.h): pacotes recebidos já chegam tipados
+  lumen_set_schema(HMI_SCHEMA, sizeof(HMI_SCHEMA) / sizeof(HMI_SCHEMA[0]));
+
+#if USE_DISPATCH
+  // Eventos da HMI: tabela indexada por endereço, consultada em O(1) no loop
+  lumen_on(ADDR_MAIN_SCREEN, onMainScreen, NULL);
+  lumen_on(ADDR_LANG_VAR, onLanguage, NULL);
+  lumen_on(ADDR_LIST_LANG, onLanguage, NULL);
+  lumen_on(ADDR_SELECTED_PRE_CURE, onSelectedPreCure, NULL);
+  lumen_on(ADDR_TIMER_START_STOP, onTimerStartStop, NULL);
+  lumen_on_range(ADDR_PRE_CURE_1, ADDR_PRE_CURE_7, onPreCure, pre_cure_values);
+#endif
 
   delay(800);                 // HMI sobe
-  HMI_FillLanguageList();     // popula 126
+  beginHMISession();
 
-  lumen_write(&langPacket, 0);                 // idioma default = inglês
+  lumen_write(&langPacket, (int32_t)0);        // idioma default = inglês
   lumen_write(&txt_start_curePacket, "Start Cure");
 
-  // Preenche presets de cura e zera estado
-  writeInt(&pre_cure_1Packet, pre_cure_values[0]);
-  writeInt(&pre_cure_2Packet, pre_cure_values[1]);
-  writeInt(&pre_cure_3Packet, pre_cure_values[2]);
-  writeInt(&pre_cure_4Packet, pre_cure_values[3]);
-  writeInt(&pre_cure_5Packet, pre_cure_values[4]);
-  writeInt(&pre_cure_6Packet, pre_cure_values[5]);
-  writeInt(&pre_cure_7Packet, pre_cure_values[6]);
-  writeInt(&selected_pre_curePacket, 0);
+  // Zera o estado; os presets vêm da HMI (readPresets, abaixo)
+  lumen_batch_begin();
   stopCure();
+  lumen_batch_commit();
 
   // Carrega idioma inicial
   int32_t cfgIdx = -1; String js;
   if (readFileToString("/config.json", js)){
     cfgIdx = parseLangIndexFromJson(js);
-    Serial.printf("config.json: lang=%ld (%s)\n", (long)cfgIdx,
-      cfgIdx==0?"EN":cfgIdx==1?"PT":cfgIdx==2?"ES":cfgIdx==3?"DE":"?");
+    Serial.printf("config.json: lang=%ld (%s)\n", (long)cfgIdx, cfgIdx >= 0 ? LangPack_Code(cfgIdx) : "?");
   } else {
     Serial.println("config.json não encontrado; usando PT");
     cfgIdx = 1;
   }
   applyLanguageIdx(cfgIdx < 0 ? 1 : cfgIdx, /*mirrorToHMI=*/true);
+  lumen_tx_flush();           // boot: pode bloquear até a fila esvaziar
   Serial.println("HMI pronta.");
+
+  // Lê a tela atual sem travar: a resposta chega pelo loop (lumen_available)
+  lumen_request_async(&main_screenPacket, 500, onMainScreenRead, NULL);
+  readPresets();
 }
 
 void loop(){
+  // Esvazia a fila TX só até onde a FIFO da UART aceita, sem bloquear o loop
+  lumen_tx_drain(HMI_TransportWritable());
+
+  // Relógio dos timeouts das leituras assíncronas
+  static uint32_t lastRequestTick_ms = millis();
+  uint32_t now_ms = millis();
+  lumen_request_tick(now_ms - lastRequestTick_ms);
+  lastRequestTick_ms = now_ms;
+
+  // Heartbeat: relê a tela atual; é também o que percebe a HMI reiniciada
+  static uint32_t lastHeartbeat_ms = millis();
+  if (now_ms - lastHeartbeat_ms >= HMI_HEARTBEAT_MS){
+    lastHeartbeat_ms = now_ms;
+    lumen_request_async(&main_screenPacket, HMI_HEARTBEAT_TIMEOUT_MS, onMainScreenRead, NULL);
+  }
+
+  // Textos descartados com a fila TX cheia: de novo quando ela esvazia
+  if (lumen_tx_pending() == 0) HMI_RenderPending();
+
   lumen_packet_t pkt;
   while (lumen_read_packet_compat(pkt)) {
 #if DEBUG_SNIFF
@@ -207,55 +382,11 @@ void loop(){
       (int)pkt.data._s8, (unsigned)pkt.data._u8,
       (const char*)pkt.data._string);
 #endif
-
-
-    uint16_t addr = pkt.address;
-    int32_t value = 0;
-    switch (pkt.type){
-      case kS32: value = pkt.data._s32; break;
-      case kU32: value = (int32_t)pkt.data._u32; break;
-      case kS16: value = (int32_t)pkt.data._s16; break;
-      case kU16: value = (int32_t)pkt.data._u16; break;
-      case kS8:  value = (int32_t)pkt.data._s8;  break;
-      case kU8:  value = (int32_t)pkt.data._u8;  break;
-      default: break;
-    }
-
-    if (addr == langListPacket.address || addr == langPacket.address){
-      int32_t idx = extractIndexLoose(pkt);
-      if (idx != INT32_MIN){
-        bool mirror = (addr == langListPacket.address); // vindo da lista, espelha 123
-        applyLanguageIdx(constrain(idx,0,3), mirror);
-      } else {
-        Serial.println("[EVT] pacote de idioma sem valor reconhecível.");
-      }
-    } else if (addr == selected_pre_cureAddress){
-      target_time_s = (value > 0) ? (uint32_t)value : 0;
-      writeInt(&selected_pre_curePacket, target_time_s);
-    } else if (addr == timer_start_stopAddress){
-      if (value == 0){
-        stopCure();
-      } else if (value == 1 || value == 2){
-        if (cureState == STATE_IDLE) startCure();
-        else if (cureState == STATE_PAUSED) resumeCure();
-      } else if (value == 3){
-        pauseCure();
-      }
-    } else if (addr == pre_cure_1Address){
-      pre_cure_values[0] = (value > 0) ? (uint32_t)value : pre_cure_values[0];
-    } else if (addr == pre_cure_2Address){
-      pre_cure_values[1] = (value > 0) ? (uint32_t)value : pre_cure_values[1];
-    } else if (addr == pre_cure_3Address){
-      pre_cure_values[2] = (value > 0) ? (uint32_t)value : pre_cure_values[2];
-    } else if (addr == pre_cure_4Address){
-      pre_cure_values[3] = (value > 0) ? (uint32_t)value : pre_cure_values[3];
-    } else if (addr == pre_cure_5Address){
-      pre_cure_values[4] = (value > 0) ? (uint32_t)value : pre_cure_values[4];
-    } else if (addr == pre_cure_6Address){
-      pre_cure_values[5] = (value > 0) ? (uint32_t)value : pre_cure_values[5];
-    } else if (addr == pre_cure_7Address){
-      pre_cure_values[6] = (value > 0) ? (uint32_t)value : pre_cure_values[6];
-    }
+#if USE_DISPATCH
+    lumen_dispatch(&pkt);
+#else
+    dispatchPacket(&pkt);
+#endif
   }
 
   if (cureState == STATE_RUNNING){
@@ -283,4 +414,27 @@ void loop(){
       }
     }
   }
+
+#if DEBUG_SNIFF
+  // Dimensiona QUANTITY_OF_PACKETS com dados de campo: pico da fila RX e perdas
+  static uint32_t lastRxStats_ms = 0;
+  if (millis() - lastRxStats_ms >= 10000UL){
+    lastRxStats_ms = millis();
+    uint32_t dropped, overruns, truncated, peak, mistyped, malformed, resyncs;
+    lumen_rx_stats(&dropped, &overruns, &truncated, &peak);
+    lumen_schema_stats(NULL, &mistyped);
+    lumen_rx_errors(&malformed, &resyncs);  // ruído no cabo aparece aqui
+    Serial.printf("[RX] pico=%lu/%u descartados=%lu overrun=%lu truncados=%lu tipo_errado=%lu malformados=%lu resync=%lu\n",
+      (unsigned long)peak, (unsigned)QUANTITY_OF_PACKETS,
+      (unsigned long)dropped, (unsigned long)overruns, (unsigned long)truncated,
+      (unsigned long)mistyped, (unsigned long)malformed, (unsigned long)resyncs);
+    HmiTransportStats ts;
+    HMI_TransportStats(&ts);
+    Serial.printf("[UART] recebidos=%lu perdidos=%lu pico_ring=%lu/%u latencia max=%luus media=%luus\n",
+      (unsigned long)ts.received, (unsigned long)ts.lost, (unsigned long)ts.peak, (unsigned)HMI_RX_RING_SIZE,
+      (unsigned long)ts.maxLatencyUs, (unsigned long)ts.avgLatencyUs);
+  }
+#endif
+
+  lumen_tx_drain(HMI_TransportWritable());
 }
@@ -4,8 +4,16 @@
 
 struct HmiBinding { uint16_t addr; StringId id; };
 
+// ===== Telas (valor de Main_Screen, 121, no projeto UnicView) =====
+// Ainda não conferidos no projeto: HOME/SETTINGS são a ordem das telas no diagrama.
+// Um ID que não está em SCREENS faz HMI_SetScreen renderizar tudo que estiver pendente,
+// e o heartbeat do MVP.ino relê 121 a cada 2 s, caso a HMI não avise a navegação
+static const int32_t SCREEN_UNKNOWN  = -1;   // antes da HMI informar a tela
+static const int32_t SCREEN_HOME     = 0;
+static const int32_t SCREEN_SETTINGS = 1;
+
 // ===== Tela Home =====
-static const HmiBinding HOME_BINDINGS[] = {
+static constexpr HmiBinding HOME_BINDINGS[] = {
   { ADDR_TXT_START,  ID_HOME_STARTCURE },   // 124
   { ADDR_TXT_CONFIG, ID_SETTINGS_TITLE },   // 122
   { ADDR_TXT_LANG,   ID_SETTINGS_LANGUAGE }, // 125
@@ -13,7 +21,7 @@ static const HmiBinding HOME_BINDINGS[] = {
 };
 
 // ===== Tela Settings (exemplo) =====
-static const HmiBinding SETTINGS_BINDINGS[] = {
+static constexpr HmiBinding SETTINGS_BINDINGS[] = {
   { ADDR_TXT_CONFIG, ID_SETTINGS_TITLE },     // 122
   { ADDR_TXT_SYSTEM, ID_HOME_MONITOR },  // 128 (use o que corresponder na sua HMI)
   { ADDR_TXT_LANG,   ID_SETTINGS_LANGUAGE },   // 125
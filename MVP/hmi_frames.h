@@ -0,0 +1,86 @@
+// Generated by host/gen_hmi_frames.cpp from hmi_bindings.h and
+// smartcure_translations.h. Do not edit; rerun the generator instead.
+#pragma once
+#include <stdint.h>
+#include "LumenProtocol.h"
+
+#define HMI_FRAMES_USE_CRC false
+#define HMI_FRAMES_AVAILABLE ((HMI_FRAMES_USE_CRC == USE_CRC) && !USE_ACK)
+
+// length: frame on the wire; size and hash: its payload, for the shadow
+struct HmiEncodedFrame { uint16_t addr; uint16_t offset; uint16_t length; uint16_t size; uint32_t hash; };
+
+static const uint8_t HMI_FRAME_DATA[351] = {
+  0x12, 0xa0, 0x7c, 0x00, 0x53, 0x74, 0x61, 0x72, 0x74, 0x20, 0x43, 0x75, 0x72, 0x69, 0x6e, 0x67,
+  0x00, 0x13, 0x12, 0xa0, 0x7a, 0x00, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x00, 0x13,
+  0x12, 0xa0, 0x7d, 0x5d, 0x00, 0x4c, 0x61, 0x6e, 0x67, 0x75, 0x61, 0x67, 0x65, 0x00, 0x13, 0x12,
+  0xa0, 0x7f, 0x00, 0x41, 0x64, 0x6d, 0x69, 0x6e, 0x00, 0x13, 0x12, 0xa0, 0x80, 0x00, 0x4d, 0x6f,
+  0x6e, 0x69, 0x74, 0x6f, 0x72, 0x20, 0x53, 0x74, 0x61, 0x74, 0x75, 0x73, 0x00, 0x13, 0x12, 0xa0,
+  0x7c, 0x00, 0x49, 0x6e, 0x69, 0x63, 0x69, 0x61, 0x72, 0x20, 0x43, 0x75, 0x72, 0x61, 0x00, 0x13,
+  0x12, 0xa0, 0x7a, 0x00, 0x43, 0x6f, 0x6e, 0x66, 0x69, 0x67, 0x75, 0x72, 0x61, 0xc3, 0xa7, 0xc3,
+  0xb5, 0x65, 0x73, 0x00, 0x13, 0x12, 0xa0, 0x7d, 0x5d, 0x00, 0x49, 0x64, 0x69, 0x6f, 0x6d, 0x61,
+  0x00, 0x13, 0x12, 0xa0, 0x7f, 0x00, 0x41, 0x64, 0x6d, 0x69, 0x6e, 0x00, 0x13, 0x12, 0xa0, 0x80,
+  0x00, 0x4d, 0x6f, 0x6e, 0x69, 0x74, 0x6f, 0x72, 0x61, 0x72, 0x20, 0x53, 0x74, 0x61, 0x74, 0x75,
+  0x73, 0x00, 0x13, 0x12, 0xa0, 0x7c, 0x00, 0x49, 0x6e, 0x69, 0x63, 0x69, 0x61, 0x72, 0x20, 0x43,
+  0x75, 0x72, 0x61, 0x64, 0x6f, 0x00, 0x13, 0x12, 0xa0, 0x7a, 0x00, 0x43, 0x6f, 0x6e, 0x66, 0x69,
+  0x67, 0x75, 0x72, 0x61, 0x63, 0x69, 0xc3, 0xb3, 0x6e, 0x00, 0x13, 0x12, 0xa0, 0x7d, 0x5d, 0x00,
+  0x49, 0x64, 0x69, 0x6f, 0x6d, 0x61, 0x00, 0x13, 0x12, 0xa0, 0x7f, 0x00, 0x41, 0x64, 0x6d, 0x69,
+  0x6e, 0x00, 0x13, 0x12, 0xa0, 0x80, 0x00, 0x4d, 0x6f, 0x6e, 0x69, 0x74, 0x6f, 0x72, 0x65, 0x61,
+  0x72, 0x20, 0x45, 0x73, 0x74, 0x61, 0x64, 0x6f, 0x00, 0x13, 0x12, 0xa0, 0x7c, 0x00, 0x41, 0x75,
+  0x73, 0x68, 0xc3, 0xa4, 0x72, 0x74, 0x75, 0x6e, 0x67, 0x20, 0x73, 0x74, 0x61, 0x72, 0x74, 0x65,
+  0x6e, 0x00, 0x13, 0x12, 0xa0, 0x7a, 0x00, 0x45, 0x69, 0x6e, 0x73, 0x74, 0x65, 0x6c, 0x6c, 0x75,
+  0x6e, 0x67, 0x65, 0x6e, 0x00, 0x13, 0x12, 0xa0, 0x7d, 0x5d, 0x00, 0x53, 0x70, 0x72, 0x61, 0x63,
+  0x68, 0x65, 0x00, 0x13, 0x12, 0xa0, 0x7f, 0x00, 0x41, 0x64, 0x6d, 0x69, 0x6e, 0x69, 0x73, 0x74,
+  0x72, 0x61, 0x74, 0x6f, 0x72, 0x00, 0x13, 0x12, 0xa0, 0x80, 0x00, 0x53, 0x74, 0x61, 0x74, 0x75,
+  0x73, 0x20, 0xc3, 0xbc, 0x62, 0x65, 0x72, 0x77, 0x61, 0x63, 0x68, 0x65, 0x6e, 0x00, 0x13,
+};
+
+static const HmiEncodedFrame HMI_FRAMES_HOME[4][4] = {
+  { // EN
+    { 124, 0, 18, 13, 0xbfb00f06u }, // "Start Curing"
+    { 122, 18, 14, 9, 0x6f3e2ea3u }, // "Settings"
+    { 125, 32, 15, 9, 0xa2ea7682u }, // "Language"
+    { 127, 47, 11, 6, 0xff4be5b6u }, // "Admin"
+  },
+  { // PT
+    { 124, 78, 18, 13, 0xd9aa7bf2u }, // "Iniciar Cura"
+    { 122, 96, 21, 16, 0xd420395fu }, // "Configurações"
+    { 125, 117, 13, 7, 0xb6be02b7u }, // "Idioma"
+    { 127, 130, 11, 6, 0xff4be5b6u }, // "Admin"
+  },
+  { // ES
+    { 124, 163, 20, 15, 0x54f2667fu }, // "Iniciar Curado"
+    { 122, 183, 20, 15, 0xe2e9743eu }, // "Configuración"
+    { 125, 203, 13, 7, 0xb6be02b7u }, // "Idioma"
+    { 127, 216, 11, 6, 0xff4be5b6u }, // "Admin"
+  },
+  { // DE
+    { 124, 250, 25, 20, 0x36286f60u }, // "Aushärtung starten"
+    { 122, 275, 19, 14, 0x9ec906b8u }, // "Einstellungen"
+    { 125, 294, 14, 8, 0x4a91ebd9u }, // "Sprache"
+    { 127, 308, 19, 14, 0x7d6e2658u }, // "Administrator"
+  },
+};
+
+static const HmiEncodedFrame HMI_FRAMES_SETTINGS[4][3] = {
+  { // EN
+    { 122, 18, 14, 9, 0x6f3e2ea3u }, // "Settings"
+    { 128, 58, 20, 15, 0x15a85d6au }, // "Monitor Status"
+    { 125, 32, 15, 9, 0xa2ea7682u }, // "Language"
+  },
+  { // PT
+    { 122, 96, 21, 16, 0xd420395fu }, // "Configurações"
+    { 128, 141, 22, 17, 0x0cc26ef7u }, // "Monitorar Status"
+    { 125, 117, 13, 7, 0xb6be02b7u }, // "Idioma"
+  },
+  { // ES
+    { 122, 183, 20, 15, 0xe2e9743eu }, // "Configuración"
+    { 128, 227, 23, 18, 0x68441c63u }, // "Monitorear Estado"
+    { 125, 203, 13, 7, 0xb6be02b7u }, // "Idioma"
+  },
+  { // DE
+    { 122, 275, 19, 14, 0x9ec906b8u }, // "Einstellungen"
+    { 128, 327, 24, 19, 0xa2140ea4u }, // "Status überwachen"
+    { 125, 294, 14, 8, 0x4a91ebd9u }, // "Sprache"
+  },
+};
@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <string.h>
+#include "user_variables.h"
+#include "hmi_langpack.h"
+
+// Formato descrito em host/gen_translations.cpp
+#define LANGPACK_PAGE_SIZE   256
+#define LANGPACK_HEADER_SIZE 44
+
+struct PackEntry { uint16_t offset; uint8_t length; uint8_t fit; };
+
+struct PackHeader {
+  uint32_t textHash;
+  uint16_t pages;
+  char code[4];
+  char name[20];
+};
+
+struct PackInfo {
+  char code[4];
+  char name[20];
+  uint32_t textHash;
+  bool present;
+};
+
+static PackInfo _info[LANG_COUNT + LANGPACK_MAX_EXTRA];
+static uint8_t _count = LANG_COUNT;
+
+// Pacote aberto
+static File _file;
+static int16_t _open = -1;                 // idioma dele; -1 = nenhum
+static PackEntry _index[STR_COUNT];
+static struct Page { int32_t number; uint32_t used; char data[LANGPACK_PAGE_SIZE]; } _pages[LANGPACK_PAGES];
+static uint32_t _tick = 0;
+static LangPackStats _stats;
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t* p) { return rd16(p) | ((uint32_t)rd16(p + 2) << 16); }
+
+// Lê e confere o cabeçalho; o arquivo fica posicionado no índice
+static bool readHeader(File& f, PackHeader& h) {
+  uint8_t raw[LANGPACK_HEADER_SIZE];
+  if (!f.seek(0) || f.read(raw, sizeof(raw)) != sizeof(raw)) return false;
+  if (memcmp(raw, "LPK1", 4) != 0) return false;
+  if (rd32(raw + 4) != STR_LAYOUT_HASH) return false;      // feito para outros StringId
+  if (rd16(raw + 12) != STR_COUNT || rd16(raw + 40) != LANGPACK_PAGE_SIZE) return false;
+  h.textHash = rd32(raw + 8);
+  h.pages = rd16(raw + 14);
+  memcpy(h.code, raw + 16, sizeof(h.code));
+  memcpy(h.name, raw + 20, sizeof(h.name));
+  h.code[sizeof(h.code) - 1] = '\0';
+  h.name[sizeof(h.name) - 1] = '\0';
+  return true;
+}
+
+static int32_t indexOfCode(const char* code, uint8_t count) {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (strcasecmp(_info[i].code, code) == 0) return i;
+  }
+  return -1;
+}
+
+static void closePack() {
+  if (_file) _file.close();
+  _open = -1;
+  for (uint8_t i = 0; i < LANGPACK_PAGES; ++i) _pages[i].number = -1;
+}
+
+void LangPack_Begin() {
+  closePack();
+  memset(_info, 0, sizeof(_info));
+  for (uint8_t i = 0; i < LANG_COUNT; ++i) strncpy(_info[i].code, LANG_CODES[i], sizeof(_info[i].code) - 1);
+  _count = LANG_COUNT;
+
+  File dir = SPIFFS.open(LANGPACK_DIR);
+  if (!dir || !dir.isDirectory()) return;
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    const char* name = f.name();
+    size_t len = strlen(name);
+    if (len < 4 || strcmp(name + len - 4, ".lpk") != 0) continue;
+    PackHeader h;
+    if (!readHeader(f, h)) {
+      Serial.printf("[LANG] %s: pacote inválido ou de outra versão\n", name);
+      _stats.failures++;
+      continue;
+    }
+    int32_t idx = indexOfCode(h.code, _count);
+    if (idx < 0) {
+      if (_count >= LANG_COUNT + LANGPACK_MAX_EXTRA || _count >= MAX_LIST_SIZE) {
+        Serial.printf("[LANG] %s: idiomas demais, ignorado\n", name);
+        continue;
+      }
+      // Extras em ordem de código: o índice de cada um não depende da ordem no SPIFFS
+      idx = _count++;
+      while (idx > LANG_COUNT && strcmp(_info[idx - 1].code, h.code) > 0) {
+        _info[idx] = _info[idx - 1];
+        --idx;
+      }
+      memset(&_info[idx], 0, sizeof(_info[idx]));
+      memcpy(_info[idx].code, h.code, sizeof(h.code));
+    }
+    memcpy(_info[idx].name, h.name, sizeof(h.name));
+    _info[idx].textHash = h.textHash;
+    _info[idx].present = true;
+  }
+  Serial.printf("[LANG] %u idiomas (%u só em pacote)\n", _count, _count - LANG_COUNT);
+}
+
+uint8_t LangPack_Count() { return _count; }
+
+const char* LangPack_Code(uint8_t idx) { return (idx < _count) ? _info[idx].code : ""; }
+
+int32_t LangPack_IndexOf(const char* code) { return indexOfCode(code, _count); }
+
+LangText LangPack_Name(uint8_t idx) {
+  const char* name = (idx >= LANG_COUNT && idx < _count) ? _info[idx].name : "";
+  uint8_t len = (uint8_t)strlen(name);
+  return { name, len, len };
+}
+
+bool LangPack_Select(uint8_t idx) {
+  if (idx >= _count) return false;
+  if (idx == _open) return true;
+  closePack();
+  const PackInfo& info = _info[idx];
+  if (!info.present) return true;
+  if (idx < LANG_COUNT && info.textHash == LANG_TEXT_HASH[idx]) return true;  // mesmo texto das tabelas
+
+  char path[32];
+  snprintf(path, sizeof(path), LANGPACK_DIR "/%s.lpk", info.code);
+  _file = SPIFFS.open(path, "r");
+  PackHeader h;
+  uint8_t raw[4];
+  bool ok = _file && readHeader(_file, h) && h.textHash == info.textHash;
+  for (uint16_t i = 0; ok && i < STR_COUNT; ++i) {
+    ok = _file.read(raw, sizeof(raw)) == sizeof(raw);
+    _index[i] = { rd16(raw), raw[2], raw[3] };
+    // Texto e '\0' dentro de uma página
+    uint32_t at = _index[i].offset % LANGPACK_PAGE_SIZE;
+    ok = ok && at + _index[i].length < LANGPACK_PAGE_SIZE && _index[i].offset / LANGPACK_PAGE_SIZE < h.pages;
+  }
+  if (!ok) {
+    Serial.printf("[LANG] %s: falhou, usando as tabelas embutidas\n", path);
+    _stats.failures++;
+    closePack();
+    return false;
+  }
+  _open = idx;
+  return true;
+}
+
+bool LangPack_Active(Language L) {
+  return _open >= 0 && (int16_t)L == _open;
+}
+
+// Página do texto em offset, lida do SPIFFS se não estiver residente
+static const char* packText(const PackEntry& e) {
+  int32_t number = e.offset / LANGPACK_PAGE_SIZE;
+  Page* victim = &_pages[0];
+  for (uint8_t i = 0; i < LANGPACK_PAGES; ++i) {
+    if (_pages[i].number == number) {
+      victim = &_pages[i];
+      break;
+    }
+    if (_pages[i].used < victim->used) victim = &_pages[i];
+  }
+  if (victim->number != number) {
+    const uint32_t pos = LANGPACK_HEADER_SIZE + STR_COUNT * 4 + (uint32_t)number * LANGPACK_PAGE_SIZE;
+    victim->number = -1;
+    if (!_file.seek(pos) || _file.read((uint8_t*)victim->data, LANGPACK_PAGE_SIZE) != LANGPACK_PAGE_SIZE) {
+      _stats.failures++;
+      return NULL;
+    }
+    victim->number = number;
+    _stats.pageReads++;
+  }
+  victim->used = ++_tick;
+  const char* text = victim->data + e.offset % LANGPACK_PAGE_SIZE;
+  return (text[e.length] == '\0') ? text : NULL;
+}
+
+LangText LangPack_Text(Language L, StringId id) {
+  if (LangPack_Active(L)) {
+    int idx = getStringIndex(id);
+    if (idx >= 0) {
+      const char* text = packText(_index[idx]);
+      if (text) {
+        _stats.lookups++;
+        return { text, _index[idx].length, _index[idx].fit };
+      }
+    }
+  }
+  return { getString(L, id), getStringLength(L, id), getStringFit(L, id) };
+}
+
+void LangPack_Stats(LangPackStats* out) {
+  if (out) *out = _stats;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include "smartcure_translations.h"
+
+// Pacotes de idioma (.lpk, gerados por host/gen_translations.cpp) em LANGPACK_DIR
+// no SPIFFS. Os índices 0..LANG_COUNT-1 são os idiomas de
+// smartcure_translations.h; um pacote com o código de um deles e texto
+// diferente o substitui (tradução atualizada sem regravar o firmware), e os
+// pacotes de outros códigos viram os índices seguintes, em ordem de código.
+// Só o pacote do idioma ativo fica aberto: o índice dele em RAM e até
+// LANGPACK_PAGES páginas de 256 B de texto, lidas sob demanda (LRU).
+
+#ifndef LANGPACK_DIR
+#define LANGPACK_DIR "/lang"
+#endif
+#ifndef LANGPACK_PAGES
+#define LANGPACK_PAGES 4
+#endif
+#define LANGPACK_MAX_EXTRA 6   // idiomas só em pacote: a lista 126 tem MAX_LIST_SIZE itens
+
+struct LangText { const char* text; uint8_t length; uint8_t fit; };  // como getString/Length/Fit
+
+struct LangPackStats {
+  uint32_t lookups;     // textos servidos pelo pacote
+  uint32_t pageReads;   // páginas lidas do SPIFFS
+  uint32_t failures;    // pacotes recusados ou leituras que falharam (cai nas tabelas embutidas)
+};
+
+// Procura os pacotes (depois de SPIFFS.begin)
+void LangPack_Begin();
+
+// Idiomas disponíveis: embutidos + só em pacote
+uint8_t LangPack_Count();
+const char* LangPack_Code(uint8_t idx);        // "de"
+int32_t LangPack_IndexOf(const char* code);    // -1 se não houver
+// Nome de um idioma só em pacote (idx >= LANG_COUNT), já cortado para a HMI
+LangText LangPack_Name(uint8_t idx);
+
+// Torna idx o idioma ativo; abre o pacote dele se houver um que mude o texto
+bool LangPack_Select(uint8_t idx);
+// L é servido por um pacote aberto (e não pelas tabelas embutidas)
+bool LangPack_Active(Language L);
+
+// Texto de id em L: do pacote aberto se for o de L, senão das tabelas embutidas.
+// O ponteiro de um pacote vale até LANGPACK_PAGES leituras de página depois.
+LangText LangPack_Text(Language L, StringId id);
+
+void LangPack_Stats(LangPackStats* out);
@@ -4,12 +4,15 @@
 #include "user_variables.h"
 #include "hmi_bindings.h"
 #include "hmi_renderer.h"
+#include "hmi_frames.h"
+#include "hmi_langpack.h"
 #include "smartcure_translations.h"
 
 // ===== Helpers de escrita =====
-static bool HMI_WriteString(uint16_t addr, const char* text) {
-  if (!text) text = "";
-  const size_t len = strlen(text) + 1;
+// textLen sem o '\0' (getStringLength já traz o tamanho pronto)
+static bool HMI_WriteString(uint16_t addr, const char* text, size_t textLen) {
+  if (!text) { text = ""; textLen = 0; }
+  const size_t len = textLen + 1;
   uint32_t sent = 0;
   if (len <= MAX_STRING_SIZE) {
     lumen_packet_t p = { addr, kString };
@@ -37,22 +40,27 @@ static bool HMI_WriteS32(uint16_t addr, int32_t v) {
   return true;
 }
 
-static bool HMI_WriteListItem(uint16_t listAddr, uint16_t index, const char* text) {
-  if (!text) text = "";
-  const uint32_t len = (uint32_t)strlen(text) + 1;
+static_assert(STR_FIT_SIZE == MAX_STRING_SIZE,
+              "smartcure_translations.h gerado com outro MAX_STRING_SIZE: rode host/gen_translations");
+
+// Itens de lista vão num único pacote: textos longos saem na variante já cortada (fit)
+static bool HMI_WriteListItem(uint16_t listAddr, uint16_t index, LangText t) {
+  const char* text = t.text;
+  const uint32_t fit = t.fit;
   uint32_t sent = 0;
-  if (len <= MAX_STRING_SIZE) {
-    sent = lumen_write_variable_list(listAddr, index, (uint8_t*)text, len);
+  if (fit == t.length) {
+    sent = lumen_write_variable_list(listAddr, index, (uint8_t*)text, fit + 1);
   } else {
     uint8_t buf[MAX_STRING_SIZE];
-    memcpy(buf, text, MAX_STRING_SIZE - 1);
-    buf[MAX_STRING_SIZE - 1] = '\0';
-    sent = lumen_write_variable_list(listAddr, index, buf, MAX_STRING_SIZE);
+    memcpy(buf, text, fit);
+    buf[fit] = '\0';
+    sent = lumen_write_variable_list(listAddr, index, buf, fit + 1);
   }
   if (sent == 0) {
     Serial.printf("[HMI] Failed to write list item addr=%u idx=%u\n", listAddr, index);
     return false;
   }
+  lumen_tx_flush();   // mantém o espaçamento de 2 ms entre itens no fio
   delay(2);
   return true;
 }
@@ -61,39 +69,160 @@ static void HMI_ClearListTail(uint16_t listAddr, uint16_t fromIndex, uint16_t to
   static const char empty[] = "";
   for (uint16_t i = fromIndex; i <= toIndex; ++i) {
     lumen_write_variable_list(listAddr, i, (uint8_t*)empty, 1);
+    lumen_tx_flush();
     delay(2);
   }
 }
 
 // ===== API =====
 void HMI_FillLanguageList() {
-  HMI_WriteListItem(ADDR_LIST_LANG, 0, getString(LANG_EN, ID_SETTINGS_LANGUAGE_EN)); // English
-  HMI_WriteListItem(ADDR_LIST_LANG, 1, getString(LANG_EN, ID_SETTINGS_LANGUAGE_PT)); // Português
-  HMI_WriteListItem(ADDR_LIST_LANG, 2, getString(LANG_EN, ID_SETTINGS_LANGUAGE_ES)); // Español
-  HMI_WriteListItem(ADDR_LIST_LANG, 3, getString(LANG_EN, ID_SETTINGS_LANGUAGE_DE)); // Deutsch
-  if (4 < MAX_LIST_SIZE) HMI_ClearListTail(ADDR_LIST_LANG, 4, MAX_LIST_SIZE - 1);
+  HMI_WriteListItem(ADDR_LIST_LANG, 0, LangPack_Text(LANG_EN, ID_SETTINGS_LANGUAGE_EN)); // English
+  HMI_WriteListItem(ADDR_LIST_LANG, 1, LangPack_Text(LANG_EN, ID_SETTINGS_LANGUAGE_PT)); // Português
+  HMI_WriteListItem(ADDR_LIST_LANG, 2, LangPack_Text(LANG_EN, ID_SETTINGS_LANGUAGE_ES)); // Español
+  HMI_WriteListItem(ADDR_LIST_LANG, 3, LangPack_Text(LANG_EN, ID_SETTINGS_LANGUAGE_DE)); // Deutsch
+  // Idiomas que só vêm em pacote (hmi_langpack), depois dos embutidos
+  const uint8_t count = LangPack_Count();
+  for (uint8_t i = LANG_COUNT; i < count; ++i) HMI_WriteListItem(ADDR_LIST_LANG, i, LangPack_Name(i));
+  if (count < MAX_LIST_SIZE) HMI_ClearListTail(ADDR_LIST_LANG, count, MAX_LIST_SIZE - 1);
+}
+
+// Fecha o lote de um render. A volta para a fila anterior vem antes do commit: se a fila
+// mudou, é ela que entrega o lote, e o resultado do commit já inclui esses textos
+static bool HMI_EndRender(lumen_tx_lane_t lane, bool ok) {
+  lumen_tx_select_lane(lane);
+  if (!lumen_batch_commit()) {
+    Serial.println("[HMI] Fila TX cheia: textos descartados, tela fica pendente");
+    return false;
+  }
+  return ok;
+}
+
+bool HMI_RenderBindings(Language L, const HmiBinding* B, size_t N) {
+  lumen_tx_lane_t lane = lumen_tx_select_lane(kLaneBulk);  // textos não atrasam tempo/progresso
+  lumen_batch_begin();
+  bool ok = true;
+  for (size_t i=0; i<N; ++i) {
+    LangText t = LangPack_Text(L, B[i].id);   // do pacote, se L vier de um
+    if (!HMI_WriteString(B[i].addr, t.text, t.length)) ok = false;
+  }
+  return HMI_EndRender(lane, ok);
+}
+
+bool HMI_RenderTexts(const HmiText* T, size_t N) {
+  lumen_tx_lane_t lane = lumen_tx_select_lane(kLaneBulk);
+  lumen_batch_begin();
+  bool ok = true;
+  for (size_t i=0; i<N; ++i) {
+    if (!HMI_WriteString(T[i].addr, T[i].text, T[i].length)) ok = false;
+  }
+  return HMI_EndRender(lane, ok);
 }
 
-void HMI_RenderBindings(Language L, const HmiBinding* B, size_t N) {
+#if HMI_FRAMES_AVAILABLE
+#define FRAMES_OF(T) (sizeof(T[0])/sizeof(T[0][0]))
+#define LANGS_OF(T)  (sizeof(T)/sizeof(T[0]))
+static_assert(FRAMES_OF(HMI_FRAMES_HOME) == sizeof(HOME_BINDINGS)/sizeof(HOME_BINDINGS[0]),
+              "hmi_frames.h desatualizado: rode host/gen_hmi_frames");
+static_assert(FRAMES_OF(HMI_FRAMES_SETTINGS) == sizeof(SETTINGS_BINDINGS)/sizeof(SETTINGS_BINDINGS[0]),
+              "hmi_frames.h desatualizado: rode host/gen_hmi_frames");
+
+// Frames já codificados em build (host/gen_hmi_frames.cpp): só copia da flash para a fila TX
+static bool HMI_RenderFrames(const HmiEncodedFrame* F, size_t N) {
+  lumen_tx_lane_t lane = lumen_tx_select_lane(kLaneBulk);
+  lumen_batch_begin();
+  bool ok = true;
   for (size_t i=0; i<N; ++i) {
-    HMI_WriteString(B[i].addr, getString(L, B[i].id));
+    if (lumen_write_encoded(F[i].addr, F[i].hash, F[i].size, &HMI_FRAME_DATA[F[i].offset], F[i].length) == 0) {
+      Serial.printf("[HMI] Failed to write string addr=%u\n", F[i].addr);
+      ok = false;
+    }
+  }
+  return HMI_EndRender(lane, ok);
+}
+#endif
+
+bool HMI_RenderHome(Language L) {
+#if HMI_FRAMES_AVAILABLE
+  if (!LangPack_Active(L) && (size_t)L < LANGS_OF(HMI_FRAMES_HOME)) {
+    return HMI_RenderFrames(HMI_FRAMES_HOME[L], FRAMES_OF(HMI_FRAMES_HOME));
   }
+#endif
+  if (!LangPack_Active(L) && (size_t)L < LANG_COUNT) {   // CRC/ACK ligados: textos prontos da flash
+    return HMI_RenderTexts(HOME_TEXTS.lang[L].items, sizeof(HOME_BINDINGS)/sizeof(HOME_BINDINGS[0]));
+  }
+  return HMI_RenderBindings(L, HOME_BINDINGS, sizeof(HOME_BINDINGS)/sizeof(HOME_BINDINGS[0]));
 }
 
-void HMI_RenderHome(Language L) {
-  HMI_RenderBindings(L, HOME_BINDINGS, sizeof(HOME_BINDINGS)/sizeof(HOME_BINDINGS[0]));
+bool HMI_RenderSettings(Language L) {
+#if HMI_FRAMES_AVAILABLE
+  if (!LangPack_Active(L) && (size_t)L < LANGS_OF(HMI_FRAMES_SETTINGS)) {
+    return HMI_RenderFrames(HMI_FRAMES_SETTINGS[L], FRAMES_OF(HMI_FRAMES_SETTINGS));
+  }
+#endif
+  if (!LangPack_Active(L) && (size_t)L < LANG_COUNT) {
+    return HMI_RenderTexts(SETTINGS_TEXTS.lang[L].items, sizeof(SETTINGS_BINDINGS)/sizeof(SETTINGS_BINDINGS[0]));
+  }
+  return HMI_RenderBindings(L, SETTINGS_BINDINGS, sizeof(SETTINGS_BINDINGS)/sizeof(SETTINGS_BINDINGS[0]));
 }
 
-void HMI_RenderSettings(Language L) {
-  HMI_RenderBindings(L, SETTINGS_BINDINGS, sizeof(SETTINGS_BINDINGS)/sizeof(SETTINGS_BINDINGS[0]));
+// ===== Tela visível =====
+// Cada tela com bindings; as que não estão aqui não têm textos traduzidos
+struct HmiScreen { int32_t id; bool (*render)(Language L); };
+static const HmiScreen SCREENS[] = {
+  { SCREEN_HOME,     HMI_RenderHome },
+  { SCREEN_SETTINGS, HMI_RenderSettings },
+};
+static const size_t SCREEN_COUNT = sizeof(SCREENS)/sizeof(SCREENS[0]);
+static_assert(SCREEN_COUNT < 32, "_staleScreens tem um bit por tela");
+
+static int32_t  _screen = SCREEN_UNKNOWN;
+static Language _screenLang = LANG_EN;   // idioma da última troca
+static uint32_t _staleScreens = 0;       // bit i: SCREENS[i] ainda em outro idioma (ou render falhou)
+
+static int HMI_ScreenIndex(int32_t screen) {
+  for (size_t i=0; i<SCREEN_COUNT; ++i) {
+    if (SCREENS[i].id == screen) return (int)i;
+  }
+  return -1;
 }
 
 void HMI_RenderAll(Language L) {
-  HMI_RenderHome(L);
-  HMI_RenderSettings(L);
+  lumen_tx_lane_t lane = lumen_tx_select_lane(kLaneBulk);
+  lumen_batch_begin();   // Home + Settings saem num único write na UART
+  uint32_t failed = 0;
+  for (size_t i=0; i<SCREEN_COUNT; ++i) {
+    if (!SCREENS[i].render(L)) failed |= 1u << i;
+  }
+  if (!HMI_EndRender(lane, true)) failed = (1u << SCREEN_COUNT) - 1;
+  _screenLang = L;
+  _staleScreens = failed;   // refeitas por HMI_RenderPending
+}
+
+void HMI_RenderLanguage(Language L) {
+  if (_screen == SCREEN_UNKNOWN) { HMI_RenderAll(L); return; }
+  _screenLang = L;
+  _staleScreens = (1u << SCREEN_COUNT) - 1;
+  HMI_SetScreen(_screen);
+}
+
+void HMI_SetScreen(int32_t screen) {
+  _screen = screen;
+  const int i = HMI_ScreenIndex(screen);
+  if (i < 0) {
+    // Tela fora de SCREENS (ID novo ou diferente no projeto UnicView): não dá para saber
+    // quais textos ela mostra, então tudo que estiver pendente sai agora
+    if (_staleScreens) HMI_RenderAll(_screenLang);
+    return;
+  }
+  if (!(_staleScreens & (1u << i))) return;
+  // Textos em comum com outra tela: o shadow não reenvia. Falhou: continua pendente
+  if (SCREENS[i].render(_screenLang)) _staleScreens &= ~(1u << i);
+}
+
+void HMI_RenderPending() {
+  if (_staleScreens) HMI_SetScreen(_screen);
 }
 
 void HMI_SyncLangVarToHMI(Language L) {
-  int idx = (L==LANG_EN)?0 : (L==LANG_PT)?1 : (L==LANG_ES)?2 : 3;
-  HMI_WriteS32(ADDR_LANG_VAR, idx);
+  HMI_WriteS32(ADDR_LANG_VAR, (int32_t)L);   // Language é o índice da lista 126
 }
@@ -1,20 +1,33 @@
 #pragma once
 #include <stddef.h>
 #include "hmi_bindings.h"
+#include "hmi_texts.h"
 #include "smartcure_translations.h"
 
-// Preenche lista 126 com "English, Português, Español, Deutsch"
+// Preenche lista 126 com "English, Português, Español, Deutsch" e os idiomas de pacote
 void HMI_FillLanguageList();
 
+// Os renders devolvem false se algum texto não coube na fila TX (e foi descartado)
+
 // Render genérico (liga bindings)
-void HMI_RenderBindings(Language L, const HmiBinding* B, size_t N);
+bool HMI_RenderBindings(Language L, const HmiBinding* B, size_t N);
+// Render de bindings já resolvidos em compilação (hmi_texts.h)
+bool HMI_RenderTexts(const HmiText* T, size_t N);
 
 // Atalhos de telas
-void HMI_RenderHome(Language L);
-void HMI_RenderSettings(Language L);
+bool HMI_RenderHome(Language L);
+bool HMI_RenderSettings(Language L);
 
-// Render tudo que já estiver mapeado (chamado ao trocar idioma)
+// Render tudo que já estiver mapeado
 void HMI_RenderAll(Language L);
 
-// Espelha o índice do idioma na var 123 (0..3)
+// Troca de idioma: só a tela visível sai agora; as outras ficam pendentes.
+// Sem tela conhecida (boot), faz HMI_RenderAll
+void HMI_RenderLanguage(Language L);
+// Tela atual (Main_Screen, 121): se estiver pendente, renderiza no idioma atual
+void HMI_SetScreen(int32_t screen);
+// Refaz a tela visível se um render dela falhou; chamar com a fila TX vazia
+void HMI_RenderPending();
+
+// Espelha o índice do idioma na var 123 (0..LangPack_Count()-1)
 void HMI_SyncLangVarToHMI(Language L);
@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "hmi_bindings.h"
+#include "smartcure_translations.h"
+
+// Bindings resolvidos em tempo de compilação: para cada tela e idioma
+// embutido, (endereço, texto, tamanho) já prontos na flash. O render só
+// percorre o array (HMI_RenderTexts), sem getString/strlen por label.
+// Idiomas de pacote (hmi_langpack) continuam em HMI_RenderBindings.
+
+struct HmiText { uint16_t addr; const char* text; uint8_t length; };
+
+template <size_t N> struct HmiTextRow { HmiText items[N]; };
+template <size_t N> struct HmiTextTable { HmiTextRow<N> lang[LANG_COUNT]; };
+
+// index_sequence do C++14, para compilar também em C++11
+template <size_t... I> struct HmiSeq {};
+template <size_t N, size_t... I> struct HmiMakeSeq : HmiMakeSeq<N - 1, N - 1, I...> {};
+template <size_t... I> struct HmiMakeSeq<0, I...> : HmiSeq<I...> {};
+
+constexpr HmiText hmiResolve(Language L, HmiBinding b) {
+  return { b.addr, getString(L, b.id), getStringLength(L, b.id) };
+}
+
+template <size_t N, size_t... I>
+constexpr HmiTextRow<N> hmiTextRow(Language L, const HmiBinding (&B)[N], HmiSeq<I...>) {
+  return {{ hmiResolve(L, B[I])... }};
+}
+
+template <size_t N, size_t... L>
+constexpr HmiTextTable<N> hmiTextTable(const HmiBinding (&B)[N], HmiSeq<L...>) {
+  return {{ hmiTextRow((Language)L, B, HmiMakeSeq<N>())... }};
+}
+
+#define HMI_TEXTS(B) hmiTextTable(B, HmiMakeSeq<LANG_COUNT>())
+
+static constexpr HmiTextTable<sizeof(HOME_BINDINGS) / sizeof(HOME_BINDINGS[0])> HOME_TEXTS = HMI_TEXTS(HOME_BINDINGS);
+static constexpr HmiTextTable<sizeof(SETTINGS_BINDINGS) / sizeof(SETTINGS_BINDINGS[0])> SETTINGS_TEXTS = HMI_TEXTS(SETTINGS_BINDINGS);
@@ -0,0 +1,237 @@
+#include <string.h>
+#include "LumenProtocol.h"
+#include "hmi_transport.h"
+
+#if (HMI_RX_RING_SIZE & (HMI_RX_RING_SIZE - 1)) != 0
+#error "HMI_RX_RING_SIZE precisa ser potência de 2"
+#endif
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+static inline uint32_t nowUs() { return micros(); }
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+static inline uint32_t nowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+#endif
+
+// ===== Ring de RX =====
+// Um produtor (evento de RX) e um consumidor (loop). head só é escrito pelo
+// produtor e tail só pelo consumidor; os índices correm livres e são mascarados.
+static uint8_t _ring[HMI_RX_RING_SIZE];
+static uint32_t _head = 0;
+static uint32_t _tail = 0;
+static uint32_t _burstStartUs = 0;   // quando o ring deixou de estar vazio
+
+// Escritos pelo produtor, lidos pelo consumidor (atômicos relaxados)
+static uint32_t _received = 0;
+static uint32_t _lost = 0;
+static uint32_t _peak = 0;
+// Escritos pelo consumidor. O reset não zera os contadores do produtor:
+// guarda onde eles estavam e as estatísticas reportam a diferença.
+static uint32_t _receivedAtReset = 0;
+static uint32_t _lostAtReset = 0;
+static uint32_t _maxLatencyUs = 0;
+static uint64_t _sumLatencyUs = 0;
+static uint32_t _bursts = 0;
+
+static void ringPush(const uint8_t* data, uint32_t length) {
+  uint32_t head = _head;
+  uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+  uint32_t room = HMI_RX_RING_SIZE - (head - tail);
+  if (length > room) {
+    __atomic_fetch_add(&_lost, length - room, __ATOMIC_RELAXED);
+    length = room;
+  }
+  if (length == 0) return;
+  if (head == tail) __atomic_store_n(&_burstStartUs, nowUs(), __ATOMIC_RELAXED);
+
+  uint32_t at = head & (HMI_RX_RING_SIZE - 1);
+  uint32_t first = HMI_RX_RING_SIZE - at;
+  if (first > length) first = length;
+  memcpy(&_ring[at], data, first);
+  memcpy(&_ring[0], data + first, length - first);
+  __atomic_store_n(&_head, head + length, __ATOMIC_RELEASE);
+
+  __atomic_fetch_add(&_received, length, __ATOMIC_RELAXED);
+  uint32_t fill = head + length - tail;
+  uint32_t peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+  while (fill > peak && !__atomic_compare_exchange_n(&_peak, &peak, fill, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static uint32_t ringPop(uint8_t* data, uint32_t max) {
+  uint32_t tail = _tail;
+  uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+  uint32_t length = head - tail;
+  if (length > max) length = max;
+  if (length == 0) return 0;
+
+  uint32_t at = tail & (HMI_RX_RING_SIZE - 1);
+  uint32_t first = HMI_RX_RING_SIZE - at;
+  if (first > length) first = length;
+  memcpy(data, &_ring[at], first);
+  memcpy(data + first, &_ring[0], length - first);
+  __atomic_store_n(&_tail, tail + length, __ATOMIC_RELEASE);
+
+  // Esvaziou: mede quanto o burst esperou (aproximado se o produtor correr junto)
+  if (tail + length == head) {
+    uint32_t latency = nowUs() - __atomic_load_n(&_burstStartUs, __ATOMIC_RELAXED);
+    if (latency > _maxLatencyUs) _maxLatencyUs = latency;
+    _sumLatencyUs += latency;
+    ++_bursts;
+  }
+  return length;
+}
+
+void HMI_TransportStats(HmiTransportStats* out) {
+  out->received = __atomic_load_n(&_received, __ATOMIC_RELAXED) - _receivedAtReset;
+  out->lost = __atomic_load_n(&_lost, __ATOMIC_RELAXED) - _lostAtReset;
+  out->peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+  out->maxLatencyUs = _maxLatencyUs;
+  out->avgLatencyUs = _bursts ? (uint32_t)(_sumLatencyUs / _bursts) : 0;
+}
+
+void HMI_TransportResetStats() {
+  _receivedAtReset = __atomic_load_n(&_received, __ATOMIC_RELAXED);
+  _lostAtReset = __atomic_load_n(&_lost, __ATOMIC_RELAXED);
+  // O pico recomeça da ocupação atual; o CAS do produtor vê a troca e refaz
+  uint32_t fill = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - _tail;
+  __atomic_store_n(&_peak, fill, __ATOMIC_RELAXED);
+  _maxLatencyUs = 0;
+  _sumLatencyUs = 0;
+  _bursts = 0;
+}
+
+// ===== Ganchos do Lumen =====
+static void transportWrite(const uint8_t* data, uint32_t length);
+
+extern "C" void lumen_write_bytes(uint8_t* data, uint32_t length) { transportWrite(data, length); }
+extern "C" uint16_t lumen_get_byte() {
+  uint8_t b;
+  return ringPop(&b, 1) ? b : DATA_NULL;
+}
+extern "C" uint32_t lumen_get_bytes(uint8_t* data, uint32_t max) { return ringPop(data, max); }
+
+#if defined(ARDUINO)
+// ===== ESP32: callback de RX da UART =====
+static HardwareSerial* _serial = nullptr;
+
+// Roda na task de eventos da UART, não no loop(): esvazia a FIFO no ring
+static void onUartReceive() {
+  uint8_t buf[64];
+  size_t n;
+  while ((n = _serial->available()) > 0) {
+    if (n > sizeof(buf)) n = sizeof(buf);
+    n = _serial->read(buf, n);
+    ringPush(buf, (uint32_t)n);
+  }
+}
+
+void HMI_TransportBegin(HardwareSerial& serial, uint32_t baud, int8_t rxPin, int8_t txPin) {
+  _serial = &serial;
+  serial.onReceive(onUartReceive);
+  serial.begin(baud, SERIAL_8N1, rxPin, txPin);
+}
+
+static void transportWrite(const uint8_t* data, uint32_t length) {
+  if (_serial) _serial->write(data, length);
+}
+
+uint32_t HMI_TransportWritable() { return _serial ? (uint32_t)_serial->availableForWrite() : 0; }
+
+#else
+// ===== Linux: pty com thread de leitura =====
+static int _fd = -1;
+static int _peerFd = -1;         // mantém o lado da HMI aberto enquanto ninguém conecta
+static char _ptyName[64] = "";
+static pthread_t _reader;
+static bool _running = false;   // __atomic: lido pela thread de leitura
+
+static const uint32_t kPtyWriteBudget = 4096;
+
+static void makeRaw(int fd) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+}
+
+static void* readerThread(void*) {
+  uint8_t buf[256];
+  struct pollfd pfd = { _fd, POLLIN, 0 };
+  while (__atomic_load_n(&_running, __ATOMIC_ACQUIRE)) {
+    if (poll(&pfd, 1, 20) <= 0) continue;
+    ssize_t n = read(_fd, buf, sizeof(buf));
+    if (n > 0) ringPush(buf, (uint32_t)n);
+    else if (n < 0 && errno != EINTR && errno != EAGAIN) usleep(1000);  // HMI desconectada
+  }
+  return nullptr;
+}
+
+bool HMI_TransportOpenPty(const char* path) {
+  if (path) {
+    _fd = open(path, O_RDWR | O_NOCTTY);
+    if (_fd < 0) { perror(path); return false; }
+    snprintf(_ptyName, sizeof(_ptyName), "%s", path);
+  } else {
+    _fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (_fd < 0 || grantpt(_fd) != 0 || unlockpt(_fd) != 0) { perror("posix_openpt"); return false; }
+    snprintf(_ptyName, sizeof(_ptyName), "%s", ptsname(_fd));
+    _peerFd = open(_ptyName, O_RDWR | O_NOCTTY);
+    if (_peerFd >= 0) makeRaw(_peerFd);
+  }
+  makeRaw(_fd);
+
+  __atomic_store_n(&_running, true, __ATOMIC_RELEASE);
+  if (pthread_create(&_reader, nullptr, readerThread, nullptr) != 0) {
+    __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+    return false;
+  }
+  return true;
+}
+
+const char* HMI_TransportPtyName() { return _ptyName; }
+
+void HMI_TransportClose() {
+  if (__atomic_load_n(&_running, __ATOMIC_ACQUIRE)) {
+    __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+    pthread_join(_reader, nullptr);
+  }
+  if (_peerFd >= 0) close(_peerFd);
+  if (_fd >= 0) close(_fd);
+  _fd = _peerFd = -1;
+}
+
+static void transportWrite(const uint8_t* data, uint32_t length) {
+  while (length > 0 && _fd >= 0) {
+    ssize_t n = write(_fd, data, length);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      return;
+    }
+    data += n;
+    length -= (uint32_t)n;
+  }
+}
+
+uint32_t HMI_TransportWritable() {
+  int queued = 0;
+  if (_fd < 0) return 0;
+  if (ioctl(_fd, TIOCOUTQ, &queued) != 0 || queued < 0) queued = 0;
+  return (uint32_t)queued < kPtyWriteBudget ? kPtyWriteBudget - (uint32_t)queued : 0;
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Transporte da HMI. Os bytes recebidos entram num ring buffer alimentado por
+// evento (callback de RX da UART no ESP32, thread de leitura do pty no Linux)
+// e o Lumen os consome no loop() por lumen_get_bytes / lumen_get_byte, que
+// estão definidos aqui. Um loop() ocupado renderizando não perde bytes
+// enquanto o ring tiver espaço.
+
+#ifndef HMI_RX_RING_SIZE
+#define HMI_RX_RING_SIZE 2048   // potência de 2
+#endif
+
+struct HmiTransportStats {
+  uint32_t received;      // bytes que entraram no ring
+  uint32_t lost;          // bytes descartados com o ring cheio
+  uint32_t peak;          // maior ocupação do ring (bytes)
+  uint32_t maxLatencyUs;  // maior espera de um burst no ring até ser lido inteiro
+  uint32_t avgLatencyUs;  // média dessa espera
+};
+
+#if defined(ARDUINO)
+#include <HardwareSerial.h>
+
+// Liga a UART com o callback de RX (Arduino-ESP32 2.0+). Substitui serial.begin.
+void HMI_TransportBegin(HardwareSerial& serial, uint32_t baud, int8_t rxPin, int8_t txPin);
+#else
+// Linux: abre o pty em path (ex.: o que o simulador da HMI imprimiu) ou, com
+// path NULL, cria um par de pty; o nome do lado da HMI sai em HMI_TransportPtyName.
+bool HMI_TransportOpenPty(const char* path);
+const char* HMI_TransportPtyName();
+void HMI_TransportClose();
+#endif
+
+// Bytes que a TX aceita agora sem bloquear (orçamento para lumen_tx_drain)
+uint32_t HMI_TransportWritable();
+
+void HMI_TransportStats(HmiTransportStats* out);
+void HMI_TransportResetStats();
@@ -1,8 +1,9 @@
-/** SmartCURE translations (UTF-8, regenerated clean) */
+// Generated by host/gen_translations.cpp from en.json, pt.json, es.json, de.json.
+// Do not edit; change the JSON files and rerun the generator.
 #pragma once
 #include <stdint.h>
 extern "C" {
-typedef enum { LANG_EN=0, LANG_PT=1, LANG_ES=2, LANG_DE=3 } Language;
+typedef enum { LANG_EN=0, LANG_PT=1, LANG_ES=2, LANG_DE=3, LANG_PACK_LAST=15 } Language;  // indexes past the built-in ones: languages that only come as packs
 typedef enum {
   ID_HOME_TITLE = 100,
   ID_HOME_SUBTITLE = 101,
@@ -150,2111 +151,677 @@ typedef enum {
   ID_COMMON_DELETE = 605,
   ID_COMMON_EDIT = 606,
   ID_COMMON_ADD = 607,
-  ID_COMMON_CONFIRM = 608,
-  ID_COMMON_YES = 609,
-  ID_COMMON_NO = 610,
-  ID_TXT_CONFIG = 611,
-  ID_TXT_START_CURE = 612,
-  ID_TXT_LANG = 613,
-  ID_TXT_ADMIN = 614,
-  ID_TXT_SYSTEM = 615,
-  ID_START_GLAZE_CURE = 616,
-  ID_TXT_SECONDS = 617,
-} StringId;
-static const char* STR_EN[518] = {
-  "Smart Dent",
-  "Dental Post-Curing System",
-  "Start Curing",
-  "Select resin and start curing process",
-  "Cure Resin",
-  "Monitor Status",
-  "View digital outputs status of the system",
-  "Access",
-  "Admin",
-  "Manage resin profiles and parameters (requires code)",
-  "Configure",
-  "Settings",
-  "Configure language and other system options",
-  "Configure",
-  "Back",
-  "Return to main menu",
-  "Home",
-  "© 2024 Smart Dent - Dental Post-Curing System",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Administrative Access",
-  "Enter access code to continue",
-  "Access code",
-  "Access",
-  "Incorrect code. Please try again.",
-  "Cancel",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Settings",
-  "Customize system settings",
-  "Language",
-  "Select interface language",
-  "Português",
-  "English",
-  "Español",
-  "Deutsch",
-  "Save",
-  "Settings saved!",
-  "Settings have been updated successfully.",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Start Curing Process",
-  "Select manufacturer and resin to start",
-  "1. Select Manufacturer",
-  "2. Select Resin",
-  "Select a manufacturer",
-  "First choose a manufacturer to see available resins",
-  "Selected",
-  "Select",
-  "resins available",
-  "Start Curing",
-  "Time",
-  "Pulses",
-  "Temp",
-  "N₂",
-  "Yes",
-  "No",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Curing Process",
-  "Curing Progress",
-  "total",
-  "Remaining",
-  "pulses",
-  "target",
-  "Nitrogen",
-  "Total Time",
-  "Ready",
-  "Running",
-  "Paused",
-  "Completed",
-  "Cancelled",
-  "Start Curing",
-  "Pause",
-  "Continue",
-  "Cancel",
-  "New Cure",
-  "Select Another Resin",
-  "Process Started",
-  "Starting cure of",
-  "Process Paused",
-  "Curing has been paused. Click continue to resume.",
-  "Process Resumed",
-  "Continuing curing process...",
-  "Process Cancelled",
-  "The curing process has been cancelled.",
-  "Curing Completed!",
-  "has been cured successfully.",
-  "Are you sure you want to cancel the curing process?",
-  "Resin not found",
-  "Back to Selection",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Monitor Outputs",
-  "Digital outputs status of the system",
-  "Refresh",
-  "ACTIVE",
-  "INACTIVE",
-  "Status",
-  "On",
-  "Off",
-  "System Summary",
-  "Active",
-  "Inactive",
-  "Total",
-  "Operational",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Resin Manufacturers",
-  "Select a manufacturer to manage their resins",
-  "Add Manufacturer",
-  "New Manufacturer",
-  "Manufacturer name",
-  "Add",
-  "Cancel",
-  "resins",
-  "Manage Resins",
-  "Click to manage this manufacturer's resins",
-  "No manufacturers registered",
-  "Add your first manufacturer to get started",
-  "Back to Manufacturers",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Manage this manufacturer's resins",
-  "Add Resin",
-  "New Resin",
-  "Resin name",
-  "Configure",
-  "No resins registered",
-  "Add the first resin for",
-  "Are you sure you want to remove this resin?",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Resin Configuration",
-  "Cure Time (seconds)",
-  "Total cure time in seconds (1 to 3600 seconds)",
-  "Number of Pulses",
-  "Number of UV light pulses (1 to 10 pulses)",
-  "Temperature (°C)",
-  "Cure temperature in degrees Celsius (20 to 100°C)",
-  "Use Nitrogen",
-  "Enable nitrogen injection during cure to prevent oxygen inhibition",
-  "Save Configuration",
-  "Delete Resin",
-  "Warning",
-  "Make sure parameters are correct before saving. Incorrect settings may affect cure quality.",
-  "Configuration saved!",
-  "Resin parameters have been updated successfully.",
-  "Resin removed!",
-  "The resin has been removed successfully.",
-  "Are you sure you want to continue?",
-  "Are you sure you want to continue?",
-  "Resin not found",
-  "Back to Resins",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Back to Main Menu",
-  "Back",
-  "Home",
-  "Save",
-  "Cancel",
-  "Delete",
-  "Edit",
-  "Add",
-  "Confirm",
-  "Yes",
-  "No",
-  "Settings",
-  "Start Cure",
-  "Language",
-  "Admin",
-  "System Information",
-  "Start Glaze Cure",
-  "Seconds",
-};
-static const char* STR_PT[518] = {
-  "Smart Dent",
-  "Sistema de Pós-Cura Dental",
-  "Iniciar Cura",
-  "Selecionar resina e iniciar processo de cura",
-  "Curar Resina",
-  "Monitorar Status",
-  "Visualizar status das saídas digitais do sistema",
-  "Acessar",
-  "Admin",
-  "Gerenciar perfis de resina e parâmetros (requer código)",
-  "Configurar",
-  "Configurações",
-  "Configurar idioma e outras opções do sistema",
-  "Configurar",
-  "Voltar",
-  "Retornar ao menu principal",
-  "Início",
-  "© 2024 Smart Dent - Sistema de Pós-Cura Dental",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Acesso Administrativo",
-  "Digite o código de acesso para continuar",
-  "Código de acesso",
-  "Acessar",
-  "Código incorreto. Tente novamente.",
-  "Cancelar",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Configurações",
-  "Personalize as configurações do sistema",
-  "Idioma",
-  "Selecione o idioma da interface",
-  "Português",
-  "English",
-  "Español",
-  "Deutsch",
-  "Salvar",
-  "Configurações salvas!",
-  "As configurações foram atualizadas com sucesso.",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Iniciar Processo de Cura",
-  "Selecione o fabricante e a resina para iniciar",
-  "1. Selecione o Fabricante",
-  "2. Selecione a Resina",
-  "Selecione um fabricante",
-  "Primeiro escolha um fabricante para ver as resinas disponíveis",
-  "Selecionado",
-  "Selecionar",
-  "resinas disponíveis",
-  "Iniciar Cura",
-  "Tempo",
-  "Pulsos",
-  "Temp",
-  "N₂",
-  "Sim",
-  "Não",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Processo de Cura",
-  "Progresso da Cura",
-  "total",
-  "Restam",
-  "pulsos",
-  "alvo",
-  "Nitrogênio",
-  "Tempo Total",
-  "Pronto",
-  "Em Execução",
-  "Pausado",
-  "Concluído",
-  "Cancelado",
-  "Iniciar Cura",
-  "Pausar",
-  "Continuar",
-  "Cancelar",
-  "Nova Cura",
-  "Selecionar Outra Resina",
-  "Processo Iniciado",
-  "Iniciando cura de",
-  "Processo Pausado",
-  "A cura foi pausada. Clique em continuar para retomar.",
-  "Processo Retomado",
-  "Continuando o processo de cura...",
-  "Processo Cancelado",
-  "O processo de cura foi cancelado.",
-  "Cura Concluída!",
-  "foi curada com sucesso.",
-  "Tem certeza que deseja cancelar o processo de cura?",
-  "Resina não encontrada",
-  "Voltar para Seleção",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Monitorar Saídas",
-  "Status das saídas digitais do sistema",
-  "Atualizar",
-  "ATIVO",
-  "INATIVO",
-  "Status",
-  "Ligado",
-  "Desligado",
-  "Resumo do Sistema",
-  "Ativos",
-  "Inativos",
-  "Total",
-  "Operacional",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Fabricantes de Resina",
-  "Selecione um fabricante para gerenciar suas resinas",
-  "Adicionar Fabricante",
-  "Novo Fabricante",
-  "Nome do fabricante",
-  "Adicionar",
-  "Cancelar",
-  "resinas",
-  "Gerenciar Resinas",
-  "Clique para gerenciar as resinas deste fabricante",
-  "Nenhum fabricante cadastrado",
-  "Adicione seu primeiro fabricante para começar",
-  "Voltar para Fabricantes",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Gerenciar resinas deste fabricante",
-  "Adicionar Resina",
-  "Nova Resina",
-  "Nome da resina",
-  "Configurar",
-  "Nenhuma resina cadastrada",
-  "Adicione a primeira resina para",
-  "Tem certeza que deseja remover esta resina?",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Configuração da Resina",
-  "Tempo de Cura (segundos)",
-  "Tempo total de cura em segundos (1 a 3600 segundos)",
-  "Número de Pulsos",
-  "Quantidade de pulsos de luz UV (1 a 10 pulsos)",
-  "Temperatura (°C)",
-  "Temperatura de cura em graus Celsius (20 a 100°C)",
-  "Usar Nitrogênio",
-  "Ativar injeção de nitrogênio durante a cura para prevenir inibição por oxigênio",
-  "Salvar Configuração",
-  "Apagar Resina",
-  "Atenção",
-  "Certifique-se de que os parâmetros estão corretos antes de salvar. Configurações incorretas podem afetar a qualidade da cura.",
-  "Configuração salva!",
-  "Os parâmetros da resina foram atualizados com sucesso.",
-  "Resina removida!",
-  "A resina foi removida com sucesso.",
-  "Tem certeza que deseja continuar?",
-  "Tem certeza que deseja continuar?",
-  "Resina não encontrada",
-  "Voltar para Resinas",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Voltar ao Menu Inicial",
-  "Voltar",
-  "Início",
-  "Salvar",
-  "Cancelar",
-  "Excluir",
-  "Editar",
-  "Adicionar",
-  "Confirmar",
-  "Sim",
-  "Não",
-  "Configurações",
-  "Iniciar Cura",
-  "Idioma",
-  "Admin",
-  "Informações do Sistema",
-  "Iniciar Cura do Glaze",
-  "Segundos",
-};
-static const char* STR_ES[518] = {
-  "Smart Dent",
-  "Sistema de Post-Curado Dental",
-  "Iniciar Curado",
-  "Seleccionar resina y iniciar proceso de curado",
-  "Curar Resina",
-  "Monitorear Estado",
-  "Ver estado de las salidas digitales del sistema",
-  "Acceder",
-  "Admin",
-  "Gestionar perfiles de resina y parámetros (requiere código)",
-  "Configurar",
-  "Configuración",
-  "Configurar idioma y otras opciones del sistema",
-  "Configurar",
-  "Volver",
-  "Regresar al menú principal",
-  "Inicio",
-  "© 2024 Smart Dent - Sistema de Post-Curado Dental",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Acceso Administrativo",
-  "Ingrese el código de acceso para continuar",
-  "Código de acceso",
-  "Acceder",
-  "Código incorrecto. Inténtelo de nuevo.",
-  "Cancelar",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Configuración",
-  "Personalizar configuración del sistema",
-  "Idioma",
-  "Seleccionar idioma de la interfaz",
-  "Português",
-  "English",
-  "Español",
-  "Deutsch",
-  "Guardar",
-  "¡Configuración guardada!",
-  "La configuración se ha actualizado correctamente.",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Iniciar Proceso de Curado",
-  "Seleccione fabricante y resina para iniciar",
-  "1. Seleccionar Fabricante",
-  "2. Seleccionar Resina",
-  "Seleccione un fabricante",
-  "Primero elija un fabricante para ver las resinas disponibles",
-  "Seleccionado",
-  "Seleccionar",
-  "resinas disponibles",
-  "Iniciar Curado",
-  "Tiempo",
-  "Pulsos",
-  "Temp",
-  "N₂",
-  "Sí",
-  "No",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Proceso de Curado",
-  "Progreso del Curado",
-  "total",
-  "Quedan",
-  "pulsos",
-  "objetivo",
-  "Nitrógeno",
-  "Tiempo Total",
-  "Listo",
-  "En Ejecución",
-  "Pausado",
-  "Completado",
-  "Cancelado",
-  "Iniciar Curado",
-  "Pausar",
-  "Continuar",
-  "Cancelar",
-  "Nuevo Curado",
-  "Seleccionar Otra Resina",
-  "Proceso Iniciado",
-  "Iniciando curado de",
-  "Proceso Pausado",
-  "El curado ha sido pausado. Haga clic en continuar para reanudar.",
-  "Proceso Reanudado",
-  "Continuando el proceso de curado...",
-  "Proceso Cancelado",
-  "El proceso de curado ha sido cancelado.",
-  "¡Curado Completado!",
-  "ha sido curada exitosamente.",
-  "¿Está seguro de que desea cancelar el proceso de curado?",
-  "Resina no encontrada",
-  "Volver a Selección",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Monitorear Salidas",
-  "Estado de las salidas digitales del sistema",
-  "Actualizar",
-  "ACTIVO",
-  "INACTIVO",
-  "Estado",
-  "Encendido",
-  "Apagado",
-  "Resumen del Sistema",
-  "Activos",
-  "Inactivos",
-  "Total",
-  "Operacional",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Fabricantes de Resina",
-  "Seleccione un fabricante para gestionar sus resinas",
-  "Agregar Fabricante",
-  "Nuevo Fabricante",
-  "Nombre del fabricante",
-  "Agregar",
-  "Cancelar",
-  "resinas",
-  "Gestionar Resinas",
-  "Haga clic para gestionar las resinas de este fabricante",
-  "No hay fabricantes registrados",
-  "Agregue su primer fabricante para comenzar",
-  "Volver a Fabricantes",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Gestionar resinas de este fabricante",
-  "Agregar Resina",
-  "Nueva Resina",
-  "Nombre de la resina",
-  "Configurar",
-  "No hay resinas registradas",
-  "Agregue la primera resina para",
-  "¿Está seguro de que desea eliminar esta resina?",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Configuración de la Resina",
-  "Tiempo de Curado (segundos)",
-  "Tiempo total de curado en segundos (1 a 3600 segundos)",
-  "Número de Pulsos",
-  "Cantidad de pulsos de luz UV (1 a 10 pulsos)",
-  "Temperatura (°C)",
-  "Temperatura de curado en grados Celsius (20 a 100°C)",
-  "Usar Nitrógeno",
-  "Activar inyección de nitrógeno durante el curado para prevenir inhibición por oxígeno",
-  "Guardar Configuración",
-  "Eliminar Resina",
-  "Advertencia",
-  "Asegúrese de que los parámetros sean correctos antes de guardar. Configuraciones incorrectas pueden afectar la calidad del curado.",
-  "¡Configuración guardada!",
-  "Los parámetros de la resina se han actualizado correctamente.",
-  "¡Resina eliminada!",
-  "La resina ha sido eliminada correctamente.",
-  "¿Está seguro de que desea continuar?",
-  "¿Está seguro de que desea continuar?",
-  "Resina no encontrada",
-  "Volver a Resinas",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Volver al Menú Principal",
-  "Volver",
-  "Inicio",
-  "Guardar",
-  "Cancelar",
-  "Eliminar",
-  "Editar",
-  "Agregar",
-  "Confirmar",
-  "Sí",
-  "No",
-  "Configuración",
-  "Iniciar Curado",
-  "Idioma",
-  "Admin",
-  "Información del Sistema",
-  "Iniciar Curado de Glaze",
-  "Segundos",
-};
-static const char* STR_DE[518] = {
-  "Smart Dent",
-  "Zahnärztliches System nach der Heizung",
-  "Fang zu heilen",
-  "Wählen Sie Harz und starten Sie den Aushärtungsprozess",
-  "Heilharz",
-  "Status überwachen",
-  "Zeigen Sie den Status des digitalen Ausgänge des Systems an",
-  "Zugang",
-  "Administrator",
-  "Verwalten Sie Harzprofile und Parameter (erfordert Code)",
-  "Konfigurieren",
-  "Einstellungen",
-  "Konfigurieren Sie Sprache und andere Systemoptionen",
-  "Konfigurieren",
-  "Zurück",
-  "Kehren Sie zum Hauptmenü zurück",
-  "Heim",
-  "© 2024 Smart Dent - zahnärztliches Post -Curing -System",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Verwaltungszugriff",
-  "Geben Sie den Zugriffscode ein, um fortzufahren",
-  "Zugangscode",
-  "Zugang",
-  "Falscher Code. ",
-  "Stornieren",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Einstellungen",
-  "Passen Sie die Systemeinstellungen an",
-  "Sprache",
-  "Wählen Sie Schnittstellensprache",
-  "Português",
-  "English",
-  "Español",
-  "Deutsch",
-  "Speichern",
-  "Einstellungen gespeichert!",
-  "Die Einstellungen wurden erfolgreich aktualisiert.",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Beginnen Sie mit dem Heilungsprozess",
-  "Wählen Sie Hersteller und Harz aus, um zu starten",
-  "1. Wählen Sie Hersteller",
-  "2. Wählen Sie Harz",
-  "Wählen Sie einen Hersteller",
-  "Wählen Sie zuerst einen Hersteller aus, um verfügbare Harze zu sehen",
-  "Ausgewählt",
-  "Wählen",
-  "Harze verfügbar",
-  "Fang zu heilen",
-  "Zeit",
-  "Impulse",
-  "Temperatur",
-  "N₂",
-  "Ja",
-  "NEIN",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Aushärtungsprozess",
-  "Härtungsfortschritt",
-  "gesamt",
-  "Übrig",
-  "Impulse",
-  "Ziel",
-  "Stickstoff",
-  "Gesamtzeit",
-  "Bereit",
-  "Läuft",
-  "Blättern",
-  "Vollendet",
-  "Abgesagt",
-  "Fang zu heilen",
-  "Pause",
-  "Weitermachen",
-  "Stornieren",
-  "Neue Heilung",
-  "Wählen Sie ein anderes Harz",
-  "Prozess begann",
-  "Heilung von",
-  "Prozess blieb stehen",
-  "Aushärtung wurde angehalten. ",
-  "Prozess wieder aufgenommen",
-  "Fortsetzung des Aushärtungsprozesses ...",
-  "Prozess storniert",
-  "Der Aushärtungsprozess wurde abgesagt.",
-  "Aushärtung abgeschlossen!",
-  "wurde erfolgreich geheilt.",
-  "Sind Sie sicher, dass Sie den Aushärtungsprozess abbrechen möchten?",
-  "Harz nicht gefunden",
-  "Zurück zur Auswahl",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Ausgänge überwachen",
-  "Digitale Ausgänge Status des Systems",
-  "Aktualisieren",
-  "AKTIV",
-  "INAKTIV",
-  "Status",
-  "An",
-  "Aus",
-  "Systemzusammenfassung",
-  "Aktiv",
-  "Inaktiv",
-  "Gesamt",
-  "Operativ",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Harzhersteller",
-  "Wählen Sie einen Hersteller aus, um seine Harze zu verwalten",
-  "Hersteller hinzufügen",
-  "Neuer Hersteller",
-  "Hersteller Name",
-  "Hinzufügen",
-  "Stornieren",
-  "Harze",
-  "Harze verwalten",
-  "Klicken Sie hier, um die Harze dieses Herstellers zu verwalten",
-  "Keine Hersteller registriert",
-  "Fügen Sie Ihren ersten Hersteller hinzu, um loszulegen",
-  "Zurück zu den Herstellern",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Verwalten Sie die Harze dieses Herstellers",
-  "Harz hinzufügen",
-  "Neues Harz",
-  "Harzname",
-  "Konfigurieren",
-  "Keine Harze registriert",
-  "Fügen Sie das erste Harz hinzu für",
-  "Sind Sie sicher, dass Sie dieses Harz entfernen möchten?",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Harzkonfiguration",
-  "Heilzeit (Sekunden)",
-  "Gesamtheilzeit in Sekunden (1 bis 3600 Sekunden)",
-  "Anzahl der Impulse",
-  "Anzahl der UV -Lichtimpulse (1 bis 10 Impulse)",
-  "Temperatur (° C)",
-  "Heiltemperatur in Grad Celsius (20 bis 100 ° C)",
-  "Verwenden Sie Stickstoff",
-  "Aktivieren Sie die Stickstoffinjektion während der Heilung, um die Hemmung der Sauerstoffhemmung zu verhindern",
-  "Konfiguration speichern",
-  "Harz löschen",
-  "Warnung",
-  "Stellen Sie sicher, dass die Parameter vor dem Speichern korrekt sind. ",
-  "Konfiguration gespeichert!",
-  "Harzparameter wurden erfolgreich aktualisiert.",
-  "Harz entfernt!",
-  "Das Harz wurde erfolgreich entfernt.",
-  "Bist du sicher, dass du weitermachen willst?",
-  "Bist du sicher, dass du weitermachen willst?",
-  "Harz nicht gefunden",
-  "Zurück zu Harzen",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "",
-  "Zurück zum Hauptmenü",
-  "Zurück",
-  "Heim",
-  "Speichern",
-  "Stornieren",
-  "Löschen",
-  "Bearbeiten",
-  "Hinzufügen",
-  "Bestätigen",
-  "Ja",
-  "NEIN",
-  "Einstellungen",
-  "Aushärtung starten",
-  "Sprache",
-  "Administrator",
-  "Systeminformationen",
-  "Glasurhärtung starten",
-  "Sekunden",
-};
-
-static inline const char** _tbl(Language lang) {
-  switch(lang) {
-    case LANG_PT: return (const char**)STR_PT;
-    case LANG_ES: return (const char**)STR_ES;
-    case LANG_DE: return (const char**)STR_DE;
-    case LANG_EN:
-    default: return (const char**)STR_EN;
-  }
+  ID_COMMON_CONFIRM = 608,
+  ID_COMMON_YES = 609,
+  ID_COMMON_NO = 610,
+  ID_TXT_CONFIG = 611,
+  ID_TXT_START_CURE = 612,
+  ID_TXT_LANG = 613,
+  ID_TXT_ADMIN = 614,
+  ID_TXT_SYSTEM = 615,
+  ID_START_GLAZE_CURE = 616,
+  ID_TXT_SECONDS = 617,
+} StringId;
+
+// Dense layout: the StringIds come in groups of STR_ID_SPAN from STR_ID_BASE,
+// each filled from its base, so an id maps to a compact index through two
+// small tables. All languages share one blob of NUL-terminated strings; per
+// language and index there is a 16-bit offset into it, the byte length
+// (without the NUL) and the length cut to fit a STR_FIT_SIZE HMI string.
+// Tables and lookups are constexpr (C++11), so a constant id resolves at
+// compile time (hmi_texts.h).
+#define LANG_COUNT 4
+#define STR_ID_BASE 100
+#define STR_ID_SPAN 50
+#define STR_GROUPS 11
+#define STR_COUNT 156
+#define STR_FIT_SIZE 11
+#define STR_LAYOUT_HASH 0x8dc2e99au  // language packs carry the hash of the ids they were made for
+
+static constexpr uint32_t LANG_TEXT_HASH[LANG_COUNT] = { 0x4521662bu, 0x91dd4baeu, 0x99e463aeu, 0x441f9bb8u };
+static constexpr const char* LANG_CODES[LANG_COUNT] = { "en", "pt", "es", "de" };
+static constexpr uint8_t STR_GROUP_FIRST[STR_GROUPS] = { 0, 18, 18, 24, 35, 51, 83, 96, 109, 117, 138 };
+static constexpr uint8_t STR_GROUP_SIZE[STR_GROUPS] = { 18, 0, 6, 11, 16, 32, 13, 13, 8, 21, 18 };
+
+static constexpr char STR_BLOB[11194] =
+  "Stellen Sie sicher, dass die Parameter vor dem Speichern korrekt sind. Falsche Einstellungen können die Aushärtungsqualität beeinträchtigen." "\0"
+  "Asegúrese de que los parámetros sean correctos antes de guardar. Configuraciones incorrectas pueden afectar la calidad del curado." "\0"
+  "Certifique-se de que os parâmetros estão corretos antes de salvar. Configurações incorretas podem afetar a qualidade da cura." "\0"
+  "Stickstoffinjektion während der Aushärtung aktivieren, um Sauerstoffinhibition zu verhindern" "\0"
+  "Make sure parameters are correct before saving. Incorrect settings may affect cure quality." "\0"
+  "Activar inyección de nitrógeno durante el curado para prevenir inhibición por oxígeno" "\0"
+  "Ativar injeção de nitrogênio durante a cura para prevenir inibição por oxigênio" "\0"
+  "Wählen Sie zuerst einen Hersteller aus, um verfügbare Harze zu sehen" "\0"
+  "Sind Sie sicher, dass Sie den Aushärtungsprozess abbrechen möchten?" "\0"
+  "Die Aushärtung wurde pausiert. Zum Fortfahren auf Weiter klicken." "\0"
+  "Enable nitrogen injection during cure to prevent oxygen inhibition" "\0"
+  "El curado ha sido pausado. Haga clic en continuar para reanudar." "\0"
+  "Primeiro escolha um fabricante para ver as resinas disponíveis" "\0"
+  "Klicken Sie hier, um die Harze dieses Herstellers zu verwalten" "\0"
+  "Los parámetros de la resina se han actualizado correctamente." "\0"
+  "Gestionar perfiles de resina y parámetros (requiere código)" "\0"
+  "Wählen Sie einen Hersteller aus, um seine Harze zu verwalten" "\0"
+  "Primero elija un fabricante para ver las resinas disponibles" "\0"
+  "Gesamte Aushärtungszeit in Sekunden (1 bis 3600 Sekunden)" "\0"
+  "¿Está seguro de que desea cancelar el proceso de curado?" "\0"
+  "Gerenciar perfis de resina e parâmetros (requer código)" "\0"
+  "Sind Sie sicher, dass Sie dieses Harz entfernen möchten?" "\0"
+  "Verwalten Sie Harzprofile und Parameter (erfordert Code)" "\0"
+  "Wählen Sie Harz und starten Sie den Aushärtungsprozess" "\0"
+  "Fügen Sie Ihren ersten Hersteller hinzu, um loszulegen" "\0"
+  "Haga clic para gestionar las resinas de este fabricante" "\0"
+  "Os parâmetros da resina foram atualizados com sucesso." "\0"
+  "Aushärtungstemperatur in Grad Celsius (20 bis 100°C)" "\0"
+  "Tiempo total de curado en segundos (1 a 3600 segundos)" "\0"
+  "A cura foi pausada. Clique em continuar para retomar." "\0"
+  "Temperatura de curado en grados Celsius (20 a 100°C)" "\0"
+  "Manage resin profiles and parameters (requires code)" "\0"
+  "Are you sure you want to cancel the curing process?" "\0"
+  "First choose a manufacturer to see available resins" "\0"
+  "Konfigurieren Sie Sprache und andere Systemoptionen" "\0"
+  "Seleccione un fabricante para gestionar sus resinas" "\0"
+  "Selecione um fabricante para gerenciar suas resinas" "\0"
+  "Status der digitalen Ausgänge des Systems anzeigen" "\0"
+  "Tem certeza que deseja cancelar o processo de cura?" "\0"
+  "Tempo total de cura em segundos (1 a 3600 segundos)" "\0"
+  "© 2024 Smart Dent – Dentales Nachhärtungssystem" "\0"
+  "Cure temperature in degrees Celsius (20 to 100°C)" "\0"
+  "Die Einstellungen wurden erfolgreich aktualisiert." "\0"
+  "La configuración se ha actualizado correctamente." "\0"
+  "Temperatura de cura em graus Celsius (20 a 100°C)" "\0"
+  "Wählen Sie Hersteller und Harz aus, um zu starten" "\0"
+  "© 2024 Smart Dent - Sistema de Post-Curado Dental" "\0"
+  "As configurações foram atualizadas com sucesso." "\0"
+  "Clique para gerenciar as resinas deste fabricante" "\0"
+  "Curing has been paused. Click continue to resume." "\0"
+  "Visualizar status das saídas digitais do sistema" "\0"
+  "¿Está seguro de que desea eliminar esta resina?" "\0"
+  "Resin parameters have been updated successfully." "\0"
+  "© 2024 Smart Dent - Sistema de Pós-Cura Dental" "\0"
+  "Geben Sie den Zugriffscode ein, um fortzufahren" "\0"
+  "Ver estado de las salidas digitales del sistema" "\0"
+  "Adicione seu primeiro fabricante para começar" "\0"
+  "Configurar idioma e outras opções do sistema" "\0"
+  "Configurar idioma y otras opciones del sistema" "\0"
+  "Harzparameter wurden erfolgreich aktualisiert." "\0"
+  "Quantidade de pulsos de luz UV (1 a 10 pulsos)" "\0"
+  "Seleccionar resina e iniciar proceso de curado" "\0"
+  "Selecione o fabricante e a resina para iniciar" "\0"
+  "Sind Sie sicher, dass Sie fortfahren möchten?" "\0"
+  "Total cure time in seconds (1 to 3600 seconds)" "\0"
+  "© 2024 Smart Dent - Dental Post-Curing System" "\0"
+  "Falscher Code. Bitte versuchen Sie es erneut." "\0"
+  "Cantidad de pulsos de luz UV (1 a 10 pulsos)" "\0"
+  "Selecionar resina e iniciar processo de cura" "\0"
+  "Select a manufacturer to manage their resins" "\0"
+  "Anzahl der UV-Lichtimpulse (1 bis 10 Pulse)" "\0"
+  "Are you sure you want to remove this resin?" "\0"
+  "Configure language and other system options" "\0"
+  "Estado de las salidas digitales del sistema" "\0"
+  "Ingrese el código de acceso para continuar" "\0"
+  "Seleccione fabricante y resina para iniciar" "\0"
+  "Tem certeza que deseja remover esta resina?" "\0"
+  "Add your first manufacturer to get started" "\0"
+  "Agregue su primer fabricante para comenzar" "\0"
+  "Click to manage this manufacturer's resins" "\0"
+  "Der Aushärtungsprozess wurde abgebrochen." "\0"
+  "La resina ha sido eliminada correctamente." "\0"
+  "Number of UV light pulses (1 to 10 pulses)" "\0"
+  "Status der digitalen Ausgänge des Systems" "\0"
+  "Verwalten Sie die Harze dieses Herstellers" "\0"
+  "Digite o código de acesso para continuar" "\0"
+  "Personalize as configurações do sistema" "\0"
+  "View digital outputs status of the system" "\0"
+  "Código incorrecto. Inténtelo de nuevo." "\0"
+  "Settings have been updated successfully." "\0"
+  "The resin has been removed successfully." "\0"
+  "Aushärtungsprozess wird fortgesetzt..." "\0"
+  "El proceso de curado ha sido cancelado." "\0"
+  "Personalizar configuración del sistema" "\0"
+  "Select manufacturer and resin to start" "\0"
+  "Status das saídas digitais do sistema" "\0"
+  "The curing process has been cancelled." "\0"
+  "¿Está seguro de que desea continuar?" "\0"
+  "Passen Sie die Systemeinstellungen an" "\0"
+  "Select resin and start curing process" "\0"
+  "Das Harz wurde erfolgreich entfernt." "\0"
+  "Digital outputs status of the system" "\0"
+  "Fügen Sie das erste Harz hinzu für" "\0"
+  "Gestionar resinas de este fabricante" "\0"
+  "Continuando el proceso de curado..." "\0"
+  "Código incorreto. Tente novamente." "\0"
+  "A resina foi removida com sucesso." "\0"
+  "Are you sure you want to continue?" "\0"
+  "Gerenciar resinas deste fabricante" "\0"
+  "Continuando o processo de cura..." "\0"
+  "Incorrect code. Please try again." "\0"
+  "Kehren Sie zum Hauptmenü zurück" "\0"
+  "Manage this manufacturer's resins" "\0"
+  "O processo de cura foi cancelado." "\0"
+  "Seleccionar idioma de la interfaz" "\0"
+  "Tem certeza que deseja continuar?" "\0"
+  "Schnittstellensprache auswählen" "\0"
+  "Adicione a primeira resina para" "\0"
+  "Selecione o idioma da interface" "\0"
+  "wurde erfolgreich ausgehärtet." "\0"
+  "Agregue la primera resina para" "\0"
+  "No hay fabricantes registrados" "\0"
+  "Enter access code to continue" "\0"
+  "Continuing curing process..." "\0"
+  "Keine Hersteller registriert" "\0"
+  "Nenhum fabricante cadastrado" "\0"
+  "ha sido curada exitosamente." "\0"
+  "has been cured successfully." "\0"
+  "Aushärtungsprozess starten" "\0"
+  "Aushärtungszeit (Sekunden)" "\0"
+  "Configuración de la Resina" "\0"
+  "No manufacturers registered" "\0"
+  "Regresar al menú principal" "\0"
+  "Tiempo de Curado (segundos)" "\0"
+  "Aushärtung abgeschlossen!" "\0"
+  "Einstellungen gespeichert!" "\0"
+  "Konfiguration gespeichert!" "\0"
+  "No hay resinas registradas" "\0"
+  "Retornar ao menu principal" "\0"
+  "Zurück zu den Herstellern" "\0"
+  "¡Configuración guardada!" "\0"
+  "1. Seleccionar Fabricante" "\0"
+  "1. Selecione o Fabricante" "\0"
+  "Customize system settings" "\0"
+  "Iniciar Proceso de Curado" "\0"
+  "Nenhuma resina cadastrada" "\0"
+  "Select interface language" "\0"
+  "Volver al Menú Principal" "\0"
+  "1. Hersteller auswählen" "\0"
+  "Configuração da Resina" "\0"
+  "Información del Sistema" "\0"
+  "Informações do Sistema" "\0"
+  "Iniciar Processo de Cura" "\0"
+  "Seleccione un fabricante" "\0"
+  "Tempo de Cura (segundos)" "\0"
+  "Add the first resin for" "\0"
+  "Anderes Harz auswählen" "\0"
+  "Configurações salvas!" "\0"
+  "Iniciar Curado de Glaze" "\0"
+  "Keine Harze registriert" "\0"
+  "Konfiguration speichern" "\0"
+  "Seleccionar Otra Resina" "\0"
+  "Selecionar Outra Resina" "\0"
+  "Selecione um fabricante" "\0"
+  "Voltar para Fabricantes" "\0"
+  "foi curada com sucesso." "\0"
+  "1. Select Manufacturer" "\0"
+  "Glasurhärtung starten" "\0"
+  "Guardar Configuración" "\0"
+  "Hersteller hinzufügen" "\0"
+  "Resina não encontrada" "\0"
+  "Voltar ao Menu Inicial" "\0"
+  "Zurück zum Hauptmenü" "\0"
+  "2. Seleccionar Resina" "\0"
+  "2. Selecione a Resina" "\0"
+  "Acceso Administrativo" "\0"
+  "Acesso Administrativo" "\0"
+  "Administrative Access" "\0"
+  "Ausgänge überwachen" "\0"
+  "Back to Manufacturers" "\0"
+  "Configuração salva!" "\0"
+  "Fabricantes de Resina" "\0"
+  "Iniciar Cura do Glaze" "\0"
+  "Nombre del fabricante" "\0"
+  "Salvar Configuração" "\0"
+  "Select a manufacturer" "\0"
+  "Systemzusammenfassung" "\0"
+  "Voltar para Seleção" "\0"
+  "Zurück zu den Harzen" "\0"
+  "Adicionar Fabricante" "\0"
+  "Configuration saved!" "\0"
+  "Härtungsfortschritt" "\0"
+  "No resins registered" "\0"
+  "Resina no encontrada" "\0"
+  "Select Another Resin" "\0"
+  "Start Curing Process" "\0"
+  "Stickstoff verwenden" "\0"
+  "Volver a Fabricantes" "\0"
+  "¡Curado Completado!" "\0"
+  "Aushärtung starten" "\0"
+  "Cure Time (seconds)" "\0"
+  "Harz nicht gefunden" "\0"
+  "Iniciando curado de" "\0"
+  "Nombre de la resina" "\0"
+  "Progreso del Curado" "\0"
+  "Prozess abgebrochen" "\0"
+  "Prozess fortgesetzt" "\0"
+  "Resin Configuration" "\0"
+  "Resin Manufacturers" "\0"
+  "Resumen del Sistema" "\0"
+  "Return to main menu" "\0"
+  "Systeminformationen" "\0"
+  "Voltar para Resinas" "\0"
+  "Volver a Selección" "\0"
+  "Zurück zur Auswahl" "\0"
+  "¡Resina eliminada!" "\0"
+  "2. Harz auswählen" "\0"
+  "Agregar Fabricante" "\0"
+  "Monitorear Salidas" "\0"
+  "Nome do fabricante" "\0"
+  "Processo Cancelado" "\0"
+  "Save Configuration" "\0"
+  "Status überwachen" "\0"
+  "System Information" "\0"
+  "Verwaltungszugriff" "\0"
+  "Back to Main Menu" "\0"
+  "Back to Selection" "\0"
+  "Curing Completed!" "\0"
+  "Código de acceso" "\0"
+  "Código de acesso" "\0"
+  "Gerenciar Resinas" "\0"
+  "Gestionar Resinas" "\0"
+  "Harzkonfiguration" "\0"
+  "Iniciando cura de" "\0"
+  "Manufacturer name" "\0"
+  "Monitorar Saídas" "\0"
+  "Monitorear Estado" "\0"
+  "Número de Pulsos" "\0"
+  "Proceso Cancelado" "\0"
+  "Proceso Reanudado" "\0"
+  "Process Cancelled" "\0"
+  "Processo Iniciado" "\0"
+  "Processo Retomado" "\0"
+  "Progresso da Cura" "\0"
+  "Prozess gestartet" "\0"
+  "Resumo do Sistema" "\0"
+  "Temperatura (°C)" "\0"
+  "Temperature (°C)" "\0"
+  "verfügbare Harze" "\0"
+  "Add Manufacturer" "\0"
+  "Adicionar Resina" "\0"
+  "Anzahl der Pulse" "\0"
+  "Cura Concluída!" "\0"
+  "Harz hinzufügen" "\0"
+  "Monitorar Status" "\0"
+  "Neue Aushärtung" "\0"
+  "Neuer Hersteller" "\0"
+  "New Manufacturer" "\0"
+  "Nuevo Fabricante" "\0"
+  "Number of Pulses" "\0"
+  "Proceso Iniciado" "\0"
+  "Processo Pausado" "\0"
+  "Prozess pausiert" "\0"
+  "Resina removida!" "\0"
+  "Start Glaze Cure" "\0"
+  "Starting cure of" "\0"
+  "Temperatur (°C)" "\0"
+  "Usar Nitrogênio" "\0"
+  "Volver a Resinas" "\0"
+  "resins available" "\0"
+  "2. Select Resin" "\0"
+  "Aushärtung von" "\0"
+  "Configurações" "\0"
+  "Curing Progress" "\0"
+  "Eliminar Resina" "\0"
+  "Harz aushärten" "\0"
+  "Harze verwalten" "\0"
+  "Monitor Outputs" "\0"
+  "Novo Fabricante" "\0"
+  "Proceso Pausado" "\0"
+  "Process Resumed" "\0"
+  "Process Started" "\0"
+  "Resin not found" "\0"
+  "Settings saved!" "\0"
+  "Usar Nitrógeno" "\0"
+  "Agregar Resina" "\0"
+  "Back to Resins" "\0"
+  "Harz entfernt!" "\0"
+  "Harzhersteller" "\0"
+  "Herstellername" "\0"
+  "Iniciar Curado" "\0"
+  "Monitor Status" "\0"
+  "Nome da resina" "\0"
+  "Process Paused" "\0"
+  "Resin removed!" "\0"
+  "System Summary" "\0"
+  "Abgeschlossen" "\0"
+  "Administrator" "\0"
+  "Aktualisieren" "\0"
+  "Apagar Resina" "\0"
+  "Einstellungen" "\0"
+  "Em Execução" "\0"
+  "En Ejecución" "\0"
+  "Harz löschen" "\0"
+  "Konfigurieren" "\0"
+  "Manage Resins" "\0"
+  "Curar Resina" "\0"
+  "Delete Resin" "\0"
+  "Iniciar Cura" "\0"
+  "Nueva Resina" "\0"
+  "Nuevo Curado" "\0"
+  "Seleccionado" "\0"
+  "Start Curing" "\0"
+  "Tiempo Total" "\0"
+  "Use Nitrogen" "\0"
+  "Abgebrochen" "\0"
+  "Access code" "\0"
+  "Advertencia" "\0"
+  "Ausgewählt" "\0"
+  "Bestätigen" "\0"
+  "Hinzufügen" "\0"
+  "Nova Resina" "\0"
+  "Operacional" "\0"
+  "Operational" "\0"
+  "Seleccionar" "\0"
+  "Selecionado" "\0"
+  "Tempo Total" "\0"
+  "Zugangscode" "\0"
+  "Actualizar" "\0"
+  "Bearbeiten" "\0"
+  "Completado" "\0"
+  "Concluído" "\0"
+  "Configurar" "\0"
+  "Cure Resin" "\0"
+  "Fortsetzen" "\0"
+  "Gesamtzeit" "\0"
+  "In Betrieb" "\0"
+  "Neues Harz" "\0"
+  "Português" "\0"
+  "Resin name" "\0"
+  "Selecionar" "\0"
+  "Smart Dent" "\0"
+  "Start Cure" "\0"
+  "Startseite" "\0"
+  "Stickstoff" "\0"
+  "Temperatur" "\0"
+  "Total Time" "\0"
+  "Abbrechen" "\0"
+  "Add Resin" "\0"
+  "Adicionar" "\0"
+  "Atenção" "\0"
+  "Atualizar" "\0"
+  "Completed" "\0"
+  "Configure" "\0"
+  "Confirmar" "\0"
+  "Continuar" "\0"
+  "Desligado" "\0"
+  "Encendido" "\0"
+  "Inactivos" "\0"
+  "New Resin" "\0"
+  "Nova Cura" "\0"
+  "Remaining" "\0"
+  "Speichern" "\0"
+  "Anzeigen" "\0"
+  "Cancelar" "\0"
+  "Continue" "\0"
+  "Eliminar" "\0"
+  "Englisch" "\0"
+  "Español" "\0"
+  "Harzname" "\0"
+  "INACTIVE" "\0"
+  "INACTIVO" "\0"
+  "Inactive" "\0"
+  "Inaktive" "\0"
+  "Inativos" "\0"
+  "Language" "\0"
+  "Löschen" "\0"
+  "New Cure" "\0"
+  "Pausiert" "\0"
+  "Segundos" "\0"
+  "Sekunden" "\0"
+  "Selected" "\0"
+  "Settings" "\0"
+  "objetivo" "\0"
+  "Acceder" "\0"
+  "Acessar" "\0"
+  "Activos" "\0"
+  "Agregar" "\0"
+  "Apagado" "\0"
+  "Confirm" "\0"
+  "Deutsch" "\0"
+  "English" "\0"
+  "Excluir" "\0"
+  "Guardar" "\0"
+  "INAKTIV" "\0"
+  "INATIVO" "\0"
+  "Impulse" "\0"
+  "Início" "\0"
+  "Refresh" "\0"
+  "Running" "\0"
+  "Seconds" "\0"
+  "Sprache" "\0"
+  "Warning" "\0"
+  "Warnung" "\0"
+  "Wählen" "\0"
+  "Zugriff" "\0"
+  "Zurück" "\0"
+  "Active" "\0"
+  "Aktive" "\0"
+  "Ativos" "\0"
+  "Bereit" "\0"
+  "Cancel" "\0"
+  "Delete" "\0"
+  "Editar" "\0"
+  "Gesamt" "\0"
+  "Idioma" "\0"
+  "Inicio" "\0"
+  "Ligado" "\0"
+  "Läuft" "\0"
+  "Pausar" "\0"
+  "Pronto" "\0"
+  "Quedan" "\0"
+  "Restam" "\0"
+  "Salvar" "\0"
+  "Select" "\0"
+  "Tiempo" "\0"
+  "Voltar" "\0"
+  "Volver" "\0"
+  "gesamt" "\0"
+  "pulses" "\0"
+  "pulsos" "\0"
+  "target" "\0"
+  "Übrig" "\0"
+  "Admin" "\0"
+  "Listo" "\0"
+  "Pause" "\0"
+  "Ready" "\0"
+  "Tempo" "\0"
+  "total" "\0"
+  "Back" "\0"
+  "Edit" "\0"
+  "Home" "\0"
+  "Nein" "\0"
+  "Não" "\0"
+  "N₂" "\0"
+  "Save" "\0"
+  "Temp" "\0"
+  "Zeit" "\0"
+  "Ziel" "\0"
+  "alvo" "\0"
+  "Add" "\0"
+  "Aus" "\0"
+  "Off" "\0"
+  "Sim" "\0"
+  "Sí" "\0"
+  "Yes" "\0"
+  "An" "\0"
+  "Ja" "\0"
+  "No" "\0"
+  "On";
+
+static constexpr uint16_t STR_OFFSET_EN[STR_COUNT] = {
+  10286, 3935, 9948, 5357, 10198, 9655, 4878, 7566, 11067, 2220, 10412, 10683, 4230, 10412, 11103, 8245,
+  11113, 3914, 7551, 6149, 9999, 7566, 5754, 10913, 10683, 6733, 10620, 6811, 10253, 10757, 10557, 10749,
+  11133, 9533, 4961, 7941, 5163, 7302, 9325, 7727, 2325, 10674, 11004, 9308, 9948, 10347, 9148, 11138,
+  11128, 11178, 11188, 7947, 9373, 11097, 10492, 11039, 11053, 9978, 10341, 11085, 10821, 9693, 10402, 8814,
+  9948, 11079, 10530, 10913, 10638, 7920, 9501, 9240, 9685, 3147, 9485, 6179, 8806, 5241, 8572, 6295,
+  2273, 9517, 8554, 9437, 5432, 10813, 10577, 10575, 9063, 11191, 11166, 9715, 10885, 10593, 9968, 10083,
+  8205, 4097, 8968, 9104, 8698, 11158, 10913, 2370, 9856, 4536, 6408, 4450, 7595, 5822, 10362, 10472,
+  10264, 10412, 7878, 7038, 4186, 8185, 8045, 3867, 9138, 4665, 8932, 2741, 9974, 979, 8460, 9883,
+  10845, 503, 7836, 3297, 9700, 5002, 5650, 5650, 9517, 9580, 8536, 11103, 11113, 11133, 10913, 10920,
+  11108, 11158, 10741, 11178, 11188, 10683, 10297, 10620, 11067, 8498, 9223, 10829,
+};
+static constexpr uint8_t STR_LENGTH_EN[STR_COUNT] = {
+  10, 25, 12, 37, 10, 14, 41, 6, 5, 52, 9, 8, 43, 9, 4, 19,
+  4, 46, 21, 29, 11, 6, 33, 6, 8, 25, 8, 25, 10, 7, 8, 7,
+  4, 15, 40, 20, 38, 22, 15, 21, 51, 8, 6, 16, 12, 4, 6, 4,
+  4, 3, 2, 14, 15, 5, 9, 6, 6, 8, 10, 5, 7, 6, 9, 9,
+  12, 5, 8, 6, 8, 20, 15, 16, 14, 49, 15, 28, 17, 38, 17, 28,
+  51, 15, 17, 15, 36, 7, 6, 8, 6, 2, 3, 14, 6, 8, 5, 11,
+  19, 44, 16, 16, 17, 3, 6, 6, 13, 42, 27, 42, 21, 33, 9, 9,
+  10, 9, 20, 23, 43, 19, 19, 46, 16, 42, 17, 50, 12, 66, 18, 12,
+  7, 91, 20, 48, 14, 40, 34, 34, 15, 14, 17, 4, 4, 4, 6, 6,
+  4, 3, 7, 3, 2, 8, 10, 8, 5, 18, 16, 7,
+};
+static constexpr uint8_t STR_FIT_EN[STR_COUNT] = {
+  10, 10, 10, 10, 10, 10, 10, 6, 5, 10, 9, 8, 10, 9, 4, 10,
+  4, 10, 10, 10, 10, 6, 10, 6, 8, 10, 8, 10, 10, 7, 8, 7,
+  4, 10, 10, 10, 10, 10, 10, 10, 10, 8, 6, 10, 10, 4, 6, 4,
+  4, 3, 2, 10, 10, 5, 9, 6, 6, 8, 10, 5, 7, 6, 9, 9,
+  10, 5, 8, 6, 8, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 7, 6, 8, 6, 2, 3, 10, 6, 8, 5, 10,
+  10, 10, 10, 10, 10, 3, 6, 6, 10, 10, 10, 10, 10, 10, 9, 9,
+  10, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  7, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 4, 4, 4, 6, 6,
+  4, 3, 7, 3, 2, 8, 10, 8, 5, 10, 10, 7,
+};
+
+static constexpr uint16_t STR_OFFSET_PT[STR_COUNT] = {
+  10286, 3367, 9896, 4052, 9870, 9053, 3197, 10709, 11067, 1604, 10187, 9357, 3538, 10187, 11018, 6600,
+  10805, 3346, 7529, 4794, 8608, 10709, 5579, 10521, 9357, 4836, 10941, 6023, 10253, 10757, 10557, 10749,
+  10997, 7086, 3047, 6963, 3773, 6707, 7485, 7230, 1111, 10107, 10275, 1154, 9896, 11091, 8763, 11138,
+  11128, 11170, 11123, 6971, 8860, 11097, 10990, 11046, 11153, 9279, 10119, 10976, 9800, 9181, 10176, 8450,
+  9896, 10969, 10432, 10521, 10482, 7206, 8824, 8680, 9172, 2112, 8842, 5720, 8441, 5856, 9019, 7278,
+  2585, 7394, 7771, 8716, 5202, 10392, 10791, 10789, 9063, 10955, 10442, 8896, 10899, 10611, 9968, 10071,
+  7639, 2481, 7815, 9453, 8422, 10372, 10521, 2473, 8626, 3097, 6237, 3491, 7254, 5685, 8985, 10059,
+  9670, 10187, 6785, 5991, 4406, 6888, 7013, 2637, 8752, 3679, 8914, 2894, 9274, 685, 7705, 9772,
+  10382, 278, 7617, 1946, 9206, 5615, 5924, 5924, 7394, 8285, 7417, 11018, 10805, 10997, 10521, 10765,
+  10927, 10372, 10422, 11170, 11123, 9357, 9896, 10941, 11067, 6938, 7661, 10656,
+};
+static constexpr uint8_t STR_LENGTH_PT[STR_COUNT] = {
+  10, 27, 12, 44, 12, 16, 49, 7, 5, 57, 10, 15, 46, 10, 6, 26,
+  7, 48, 21, 41, 17, 7, 35, 8, 15, 41, 6, 31, 10, 7, 8, 7,
+  6, 23, 49, 24, 46, 25, 21, 23, 63, 11, 10, 20, 12, 5, 6, 4,
+  4, 3, 4, 16, 17, 5, 6, 6, 4, 11, 11, 6, 13, 7, 10, 9,
+  12, 6, 9, 8, 9, 23, 17, 17, 16, 53, 17, 33, 18, 33, 16, 23,
+  51, 22, 21, 17, 38, 9, 5, 7, 6, 6, 9, 17, 6, 8, 5, 11,
+  21, 51, 20, 15, 18, 9, 8, 7, 17, 49, 28, 46, 23, 34, 16, 11,
+  14, 10, 25, 31, 43, 24, 24, 51, 17, 46, 17, 50, 16, 85, 21, 13,
+  9, 129, 21, 55, 16, 34, 33, 33, 22, 19, 22, 6, 7, 6, 8, 7,
+  6, 9, 9, 3, 4, 15, 12, 6, 5, 24, 21, 8,
+};
+static constexpr uint8_t STR_FIT_PT[STR_COUNT] = {
+  10, 10, 10, 10, 10, 10, 10, 7, 5, 10, 10, 9, 10, 10, 6, 10,
+  7, 10, 10, 10, 10, 7, 10, 8, 9, 10, 6, 10, 10, 7, 8, 7,
+  6, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 5, 6, 4,
+  4, 3, 4, 10, 10, 5, 6, 6, 4, 10, 10, 6, 10, 7, 10, 9,
+  10, 6, 9, 8, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 9, 5, 7, 6, 6, 9, 10, 6, 8, 5, 10,
+  10, 10, 10, 10, 10, 9, 8, 7, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  9, 10, 9, 10, 10, 10, 10, 10, 10, 10, 10, 6, 7, 6, 8, 7,
+  6, 9, 9, 3, 4, 9, 10, 6, 5, 9, 10, 8,
+};
+
+static constexpr uint16_t STR_OFFSET_ES[STR_COUNT] = {
+  10286, 3017, 9640, 3726, 9870, 8734, 3443, 10701, 11067, 1301, 10187, 7356, 3585, 10187, 11025, 6436,
+  10948, 2996, 7507, 4318, 8590, 10701, 4920, 10521, 7356, 5123, 10941, 5890, 10253, 10757, 10557, 10749,
+  10773, 6654, 2843, 6759, 4362, 6681, 7463, 6988, 1425, 9935, 10095, 1466, 9640, 11011, 8763, 11138,
+  11128, 11174, 11188, 6767, 8125, 11097, 10983, 11046, 10692, 9554, 9961, 11073, 9814, 9181, 10165, 8450,
+  9640, 10969, 10432, 10521, 9922, 7182, 9155, 8085, 9469, 1046, 8788, 5543, 8770, 5083, 8004, 6266,
+  1545, 7899, 8305, 8403, 4274, 10143, 10586, 10584, 8745, 10452, 10733, 8225, 10717, 10462, 9968, 10071,
+  7639, 2429, 8384, 9121, 7683, 10725, 10521, 2473, 8644, 1890, 6118, 4493, 7983, 5506, 9565, 9909,
+  8105, 10187, 6573, 6087, 3247, 6380, 6464, 2057, 8752, 4007, 8914, 2166, 9549, 595, 7348, 9389,
+  10011, 145, 6654, 1238, 8345, 4622, 5280, 5280, 7899, 9291, 6837, 11025, 10948, 10773, 10521, 10539,
+  10927, 10725, 10422, 11174, 11188, 7356, 9640, 10941, 11067, 6913, 7110, 10656,
+};
+static constexpr uint8_t STR_LENGTH_ES[STR_COUNT] = {
+  10, 29, 14, 46, 12, 17, 47, 7, 5, 61, 10, 14, 46, 10, 6, 27,
+  6, 50, 21, 43, 17, 7, 40, 8, 14, 39, 6, 33, 10, 7, 8, 7,
+  7, 26, 50, 25, 43, 25, 21, 24, 60, 12, 11, 19, 14, 6, 6, 4,
+  4, 3, 2, 17, 19, 5, 6, 6, 8, 10, 12, 5, 13, 7, 10, 9,
+  14, 6, 9, 8, 12, 23, 16, 19, 15, 64, 17, 35, 17, 39, 20, 28,
+  58, 20, 19, 18, 43, 10, 6, 8, 6, 9, 7, 19, 7, 9, 5, 11,
+  21, 51, 18, 16, 21, 7, 8, 7, 17, 55, 30, 42, 20, 36, 14, 12,
+  19, 10, 26, 30, 49, 27, 27, 54, 17, 44, 17, 53, 15, 89, 22, 15,
+  11, 132, 26, 62, 19, 42, 38, 38, 20, 16, 25, 6, 6, 7, 8, 8,
+  6, 7, 9, 3, 2, 14, 14, 6, 5, 24, 23, 8,
+};
+static constexpr uint8_t STR_FIT_ES[STR_COUNT] = {
+  10, 10, 10, 10, 10, 10, 10, 7, 5, 10, 10, 10, 10, 10, 6, 10,
+  6, 10, 10, 10, 10, 7, 10, 8, 10, 10, 6, 10, 10, 7, 8, 7,
+  7, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 6, 6, 4,
+  4, 3, 2, 10, 10, 5, 6, 6, 8, 10, 10, 5, 10, 7, 10, 9,
+  10, 6, 9, 8, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 6, 8, 6, 9, 7, 10, 7, 9, 5, 10,
+  10, 10, 10, 10, 10, 7, 8, 7, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 9, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 6, 6, 7, 8, 8,
+  6, 7, 9, 3, 2, 10, 10, 6, 5, 9, 10, 8,
+};
+
+static constexpr uint16_t STR_OFFSET_DE[STR_COUNT] = {
+  10286, 2712, 8025, 1777, 9405, 8479, 2533, 10512, 9744, 1720, 9842, 9786, 2377, 9842, 10877, 5788,
+  10308, 2689, 8517, 3395, 10131, 10869, 3961, 10352, 9786, 5319, 10837, 5958, 10253, 10548, 10557, 10749,
+  10502, 6519, 2792, 6324, 2945, 6863, 8365, 6866, 771, 10023, 10861, 8950, 8025, 11143, 10797, 10330,
+  11128, 11185, 11118, 1814, 7857, 11032, 11060, 10797, 11148, 10319, 10220, 10906, 10962, 10647, 9730, 9987,
+  8025, 11079, 10209, 10352, 9070, 7062, 8878, 9341, 9189, 912, 8165, 5043, 8145, 4579, 6492, 6055,
+  842, 8065, 8325, 7573, 4708, 9758, 10783, 10781, 9063, 11182, 11162, 7749, 10892, 10602, 10934, 10231,
+  9610, 1363, 7371, 9087, 9625, 10047, 10352, 8962, 9421, 1175, 6208, 1834, 6627, 4751, 9036, 10242,
+  10566, 9842, 7134, 5469, 1662, 8662, 6352, 1486, 9002, 4142, 9257, 2002, 7962, 408, 7158, 9828,
+  10853, 0, 6546, 3632, 9595, 5395, 3820, 3820, 8065, 7793, 7440, 10877, 10308, 10502, 10352, 10629,
+  10154, 10047, 10035, 11185, 11118, 9786, 8025, 10837, 9744, 8265, 7325, 10665,
+};
+static constexpr uint8_t STR_LENGTH_DE[STR_COUNT] = {
+  10, 28, 19, 56, 15, 18, 51, 8, 13, 56, 13, 13, 51, 13, 7, 33,
+  10, 51, 18, 47, 11, 7, 45, 9, 13, 37, 7, 32, 10, 8, 8, 7,
+  9, 26, 50, 27, 50, 24, 18, 21, 70, 11, 7, 17, 19, 4, 7, 10,
+  4, 2, 4, 19, 20, 6, 6, 7, 4, 10, 10, 6, 6, 8, 13, 11,
+  19, 5, 10, 9, 16, 23, 17, 15, 16, 66, 19, 39, 19, 42, 26, 31,
+  69, 19, 19, 21, 42, 13, 5, 7, 6, 2, 3, 21, 6, 8, 6, 10,
+  14, 61, 22, 16, 14, 11, 9, 5, 15, 62, 28, 55, 26, 42, 16, 10,
+  8, 13, 23, 36, 57, 17, 27, 58, 16, 43, 16, 54, 20, 94, 23, 13,
+  7, 144, 26, 46, 14, 36, 46, 46, 19, 21, 22, 7, 10, 9, 9, 8,
+  10, 11, 11, 2, 4, 13, 19, 7, 13, 19, 22, 8,
+};
+static constexpr uint8_t STR_FIT_DE[STR_COUNT] = {
+  10, 10, 10, 10, 9, 10, 10, 8, 10, 10, 10, 10, 10, 10, 7, 10,
+  10, 10, 10, 10, 10, 7, 10, 9, 10, 10, 7, 10, 10, 8, 8, 7,
+  9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 7, 10, 10, 4, 7, 10,
+  4, 2, 4, 10, 10, 6, 6, 7, 4, 10, 10, 6, 6, 8, 10, 10,
+  10, 5, 10, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 5, 7, 6, 2, 3, 10, 6, 8, 6, 10,
+  10, 10, 10, 10, 10, 10, 9, 5, 10, 10, 10, 10, 10, 10, 10, 10,
+  8, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+  7, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 7, 10, 9, 9, 8,
+  10, 10, 10, 2, 4, 10, 10, 7, 10, 10, 10, 8,
+};
+
+typedef struct { const char* blob; const uint16_t* offset; const uint8_t* length; const uint8_t* fit; } StringPack;
+static constexpr StringPack STR_PACKS[LANG_COUNT] = {
+  { STR_BLOB, STR_OFFSET_EN, STR_LENGTH_EN, STR_FIT_EN },
+  { STR_BLOB, STR_OFFSET_PT, STR_LENGTH_PT, STR_FIT_PT },
+  { STR_BLOB, STR_OFFSET_ES, STR_LENGTH_ES, STR_FIT_ES },
+  { STR_BLOB, STR_OFFSET_DE, STR_LENGTH_DE, STR_FIT_DE },
+};
+
+static constexpr unsigned _strGroup(StringId id) { return ((unsigned)id - STR_ID_BASE) / STR_ID_SPAN; }
+static constexpr unsigned _strSlot(StringId id) { return ((unsigned)id - STR_ID_BASE) % STR_ID_SPAN; }
+// Compact index of an id, or -1 when the id has no string.
+static constexpr int getStringIndex(StringId id) {
+  return (_strGroup(id) < STR_GROUPS && _strSlot(id) < STR_GROUP_SIZE[_strGroup(id)])
+      ? STR_GROUP_FIRST[_strGroup(id)] + (int)_strSlot(id) : -1;
+}
+static constexpr const StringPack* _pack(Language lang) {
+  return &STR_PACKS[((unsigned)lang < LANG_COUNT) ? lang : LANG_EN];
+}
+static constexpr const char* getString(Language lang, StringId id) {
+  return (getStringIndex(id) < 0) ? "" : _pack(lang)->blob + _pack(lang)->offset[getStringIndex(id)];
+}
+// strlen(getString(lang, id)), from the table.
+static constexpr uint8_t getStringLength(Language lang, StringId id) {
+  return (getStringIndex(id) < 0) ? 0 : _pack(lang)->length[getStringIndex(id)];
+}
+// Leading bytes of getString(lang, id) that fit a STR_FIT_SIZE string with
+// its NUL, cut on a character boundary; the whole length when it fits.
+static constexpr uint8_t getStringFit(Language lang, StringId id) {
+  return (getStringIndex(id) < 0) ? 0 : _pack(lang)->fit[getStringIndex(id)];
 }
-static inline const char* getString(Language lang, StringId id) {
-  int idx = (int)id - 100;
-  if (idx < 0 || idx >= 518) return "";
-  return _tbl(lang)[idx];
-}
 
 } // extern "C"
@@ -29,28 +29,40 @@ static const uint16_t ADDR_PROGRESS_PERMILLE = 141; // Progress bar (0-1000 perm
 
 static const uint16_t MAX_LIST_SIZE          = 10;
 
+// Every HMI variable as X(name, address, type). Expands into the
+// <name>Packet instances below and into HMI_SCHEMA, which lumen_set_schema
+// uses to type the packets received from the HMI.
+#define HMI_VARIABLES(X) \
+  X(main_screen,       ADDR_MAIN_SCREEN,        kS32)     /* Selected screen ID */                    \
+  X(txt_config,        ADDR_TXT_CONFIG,         kString)  /* Config label text */                     \
+  X(lang,              ADDR_LANG_VAR,           kS32)     /* Language setting */                      \
+  X(txt_start_cure,    ADDR_TXT_START,          kString)  /* Start cure label text */                 \
+  X(txt_lang,          ADDR_TXT_LANG,           kString)  /* Language label text */                   \
+  X(list_lang,         ADDR_LIST_LANG,          kS32)     /* Language list index */                   \
+  X(txt_admin,         ADDR_TXT_ADMIN,          kString)  /* Admin label text */                      \
+  X(txt_system,        ADDR_TXT_SYSTEM,         kString)  /* System label text */                     \
+  X(start_glaze_cure,  ADDR_START_GLAZE_CURE,   kString)  /* Start glaze cure label text */           \
+  X(pre_cure_1,        ADDR_PRE_CURE_1,         kS32)     /* Pre-cure stage 1 time (HMI updatable) */ \
+  X(pre_cure_2,        ADDR_PRE_CURE_2,         kS32)     /* Pre-cure stage 2 time (HMI updatable) */ \
+  X(pre_cure_3,        ADDR_PRE_CURE_3,         kS32)     /* Pre-cure stage 3 time (HMI updatable) */ \
+  X(pre_cure_4,        ADDR_PRE_CURE_4,         kS32)     /* Pre-cure stage 4 time (HMI updatable) */ \
+  X(pre_cure_5,        ADDR_PRE_CURE_5,         kS32)     /* Pre-cure stage 5 time (HMI updatable) */ \
+  X(pre_cure_6,        ADDR_PRE_CURE_6,         kS32)     /* Pre-cure stage 6 time (HMI updatable) */ \
+  X(pre_cure_7,        ADDR_PRE_CURE_7,         kS32)     /* Pre-cure stage 7 time (HMI updatable) */ \
+  X(txt_seconds,       ADDR_TXT_SECONDS,        kString)  /* Seconds label text */                    \
+  X(selected_pre_cure, ADDR_SELECTED_PRE_CURE,  kS32)     /* Selected pre-cure preset */              \
+  X(time_curando,      ADDR_TIME_CURANDO,       kS32)     /* Elapsed curing time (s) */               \
+  X(timer_start_stop,  ADDR_TIMER_START_STOP,   kS32)     /* Timer control state */                   \
+  X(progress_permille, ADDR_PROGRESS_PERMILLE,  kS32)     /* Progress 0-1000 (permille) */
+
 // Packet instances
-static lumen_packet_t main_screenPacket       = { ADDR_MAIN_SCREEN, kS32 };   // Selected screen ID
-static lumen_packet_t txt_configPacket        = { ADDR_TXT_CONFIG, kString }; // Config label text
-static lumen_packet_t langPacket              = { ADDR_LANG_VAR, kS32 };      // Language setting
-static lumen_packet_t txt_start_curePacket    = { ADDR_TXT_START, kString };  // Start cure label text
-static lumen_packet_t txt_langPacket          = { ADDR_TXT_LANG, kString };   // Language label text
-static lumen_packet_t list_langPacket         = { ADDR_LIST_LANG, kS32 };     // Language list index
-static lumen_packet_t txt_adminPacket         = { ADDR_TXT_ADMIN, kString };  // Admin label text
-static lumen_packet_t txt_systemPacket        = { ADDR_TXT_SYSTEM, kString }; // System label text
-static lumen_packet_t start_glaze_curePacket  = { ADDR_START_GLAZE_CURE, kString }; // Start glaze cure label text
-static lumen_packet_t pre_cure_1Packet        = { ADDR_PRE_CURE_1, kS32 };    // Pre-cure stage 1 time (HMI updatable)
-static lumen_packet_t pre_cure_2Packet        = { ADDR_PRE_CURE_2, kS32 };    // Pre-cure stage 2 time (HMI updatable)
-static lumen_packet_t pre_cure_3Packet        = { ADDR_PRE_CURE_3, kS32 };    // Pre-cure stage 3 time (HMI updatable)
-static lumen_packet_t pre_cure_4Packet        = { ADDR_PRE_CURE_4, kS32 };    // Pre-cure stage 4 time (HMI updatable)
-static lumen_packet_t pre_cure_5Packet        = { ADDR_PRE_CURE_5, kS32 };    // Pre-cure stage 5 time (HMI updatable)
-static lumen_packet_t pre_cure_6Packet        = { ADDR_PRE_CURE_6, kS32 };    // Pre-cure stage 6 time (HMI updatable)
-static lumen_packet_t pre_cure_7Packet        = { ADDR_PRE_CURE_7, kS32 };    // Pre-cure stage 7 time (HMI updatable)
-static lumen_packet_t txt_secondsPacket       = { ADDR_TXT_SECONDS, kString }; // Seconds label text
-static lumen_packet_t selected_pre_curePacket = { ADDR_SELECTED_PRE_CURE, kS32 }; // Selected pre-cure preset
-static lumen_packet_t time_curandoPacket      = { ADDR_TIME_CURANDO, kS32 }; // Elapsed curing time (s)
-static lumen_packet_t timer_start_stopPacket  = { ADDR_TIMER_START_STOP, kS32 }; // Timer control state
-static lumen_packet_t progress_permillePacket = { ADDR_PROGRESS_PERMILLE, kS32 }; // Progress 0-1000 (permille)
+#define HMI_DEFINE_PACKET(name, address, type) static lumen_packet_t name##Packet = { address, type };
+HMI_VARIABLES(HMI_DEFINE_PACKET)
+#undef HMI_DEFINE_PACKET
+
+#define HMI_SCHEMA_ENTRY(name, address, type) { address, type },
+static const lumen_variable_t HMI_SCHEMA[] = { HMI_VARIABLES(HMI_SCHEMA_ENTRY) };
+#undef HMI_SCHEMA_ENTRY
 
 // Helper functions for writing values to the HMI variables
 inline void lumen_write(lumen_packet_t* p, int32_t value) {
@@ -0,0 +1,92 @@
+// Host micro-benchmark: Lumen CRC16 (polynomial 0xA001, init 0xFFFF).
+//
+// Compares the table-driven lumen_crc16() against the original
+// bit-at-a-time loop of calculate_crc / lumen_project_update_calculate_crc,
+// over the frame sizes the link actually carries. The last column is the
+// share of one byte time at 115200 baud spent computing the CRC, so it
+// tells whether USE_CRC can be turned on without slowing the link.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP bench_crc.c -o bench_crc && ./bench_crc
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+#define kBaudRate 115200.0
+#define kByteTimeNs (1e9 * 10.0 / kBaudRate)
+
+static uint16_t legacy_crc16(uint16_t crc, const uint8_t *data, uint32_t length) {
+  for (uint32_t pos = 0; pos < length; ++pos) {
+    crc ^= data[pos];
+    for (uint32_t i = 8; i != 0; --i) {
+      if (crc & 0x0001) {
+        crc >>= 1;
+        crc ^= 0xA001;
+      } else {
+        crc >>= 1;
+      }
+    }
+  }
+  return crc;
+}
+
+// Receive side as it is fed: one byte per call.
+static uint16_t table_crc16_bytewise(uint16_t crc, const uint8_t *data, uint32_t length) {
+  for (uint32_t pos = 0; pos < length; ++pos) {
+    crc = lumen_crc16_update(crc, data[pos]);
+  }
+  return crc;
+}
+
+typedef uint16_t (*crc_fn_t)(uint16_t, const uint8_t *, uint32_t);
+
+static double run(crc_fn_t fn, const uint8_t *data, uint32_t length, uint32_t iterations) {
+  volatile uint16_t sink = 0;
+  double start = now_ns();
+  for (uint32_t it = 0; it < iterations; ++it) {
+    sink ^= fn(0xFFFF, data, length);
+  }
+  (void)sink;
+  return (now_ns() - start) / ((double)iterations * length);
+}
+
+static void bench(const char *name, const uint8_t *data, uint32_t length) {
+  uint32_t iterations = (16u * 1024u * 1024u) / length;
+
+  uint16_t legacy = legacy_crc16(0xFFFF, data, length);
+  if (legacy != lumen_crc16(0xFFFF, data, length) || legacy != table_crc16_bytewise(0xFFFF, data, length)) {
+    printf("%-22s MISMATCH\n", name);
+    return;
+  }
+
+  double legacyNs = run(legacy_crc16, data, length, iterations);
+  double tableNs = run(lumen_crc16, data, length, iterations);
+  double streamNs = run(table_crc16_bytewise, data, length, iterations);
+  printf("%-22s %5u B  bitwise %6.3f ns/B  table %6.3f ns/B  rx stream %6.3f ns/B  x%.2f  %.3f%% of link\n",
+         name, length, legacyNs, tableNs, streamNs, legacyNs / tableNs, 100.0 * streamNs / kByteTimeNs);
+}
+
+int main() {
+  static uint8_t buffer[4096];
+  uint32_t seed = 1;
+
+  // Command, address and a s32 value: a typical cure/progress update.
+  static const uint8_t s32Frame[] = { WRITE_FLAG, 141, 0, 0xE8, 0x03, 0x00, 0x00 };
+  bench("s32 frame", s32Frame, sizeof(s32Frame));
+
+  uint8_t labelFrame[3 + 13] = { WRITE_FLAG, 150, 0 };
+  memcpy(&labelFrame[3], "Iniciar cura", 13);
+  bench("string label frame", labelFrame, sizeof(labelFrame));
+
+  for (uint32_t i = 0; i < sizeof(buffer); ++i) {
+    seed = seed * 1103515245u + 12345u;
+    buffer[i] = (uint8_t)(seed >> 16);
+  }
+  bench("max string frame", buffer, 3 + MAX_STRING_SIZE);
+  bench("project image block", buffer, 1024);
+  bench("random 4 KiB", buffer, sizeof(buffer));
+  return 0;
+}
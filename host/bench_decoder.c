@@ -0,0 +1,226 @@
+// Host benchmark: Lumen RX decoder cost on clean and damaged input.
+//
+// Decodes a set of streams per byte (getByte) and per span (getBytes) and
+// prints ns per input byte, the packets that came out and the decoder's
+// error counters:
+//   clean      reply frames as the HMI sends them
+//   corrupted  the same with one byte in 64 replaced by noise
+//   truncated  frames cut at a random point, never ended
+//   escapes    payloads made only of flag bytes, so every byte is escaped
+//   noise      uniformly random bytes
+//   oversize   frames longer than the input buffer
+// Any file given on the command line is decoded too, as a recorded capture
+// of the HMI's UART output.
+//
+// The worst row bounds the decoder's CPU cost. The last column is the share
+// of one byte time at 115200 baud it takes, on this host.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP bench_decoder.c -o bench_decoder && ./bench_decoder [capture.bin ...]
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+#define kStreamSize (64u * 1024u)
+#define kRounds 100u
+#define kBurst 64u
+#define kByteTimeNs (1e9 * 10.0 / 115200.0)
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t position;
+  uint32_t burstEnd;
+} stream_t;
+
+static void discard_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  (void)data;
+  (void)length;
+}
+
+__attribute__((noinline)) static uint16_t stream_get_byte(void *user) {
+  stream_t *stream = (stream_t *)user;
+  if (stream->position >= stream->burstEnd) {
+    return DATA_NULL;
+  }
+  return stream->data[stream->position++];
+}
+
+__attribute__((noinline)) static uint32_t stream_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  stream_t *stream = (stream_t *)user;
+  uint32_t length = stream->burstEnd - stream->position;
+  if (length > max) {
+    length = max;
+  }
+  memcpy(data, &stream->data[stream->position], length);
+  stream->position += length;
+  return length;
+}
+
+static uint32_t _seed = 1;
+
+static uint32_t next_random() {
+  _seed = _seed * 1103515245u + 12345u;
+  return _seed >> 8;
+}
+
+static uint32_t put_escaped(uint8_t *out, uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    out[0] = ESCAPE_FLAG;
+    out[1] = value ^ XOR_FLAG;
+    return 2;
+  }
+  out[0] = value;
+  return 1;
+}
+
+static uint32_t put_frame(uint8_t *out, uint16_t address, const uint8_t *payload, uint32_t length, bool end) {
+  uint32_t index = 0;
+  out[index++] = START_FLAG;
+  out[index++] = READ_FLAG;
+  index += put_escaped(&out[index], address & 0xFF);
+  index += put_escaped(&out[index], address >> 8);
+  for (uint32_t i = 0; i < length; ++i) {
+    index += put_escaped(&out[index], payload[i]);
+  }
+  if (end) {
+    out[index++] = END_FLAG;
+  }
+  return index;
+}
+
+typedef enum {
+  kClean,
+  kCorrupted,
+  kTruncated,
+  kEscapes,
+  kNoise,
+  kOversize,
+  kQuantityOfStreams
+} stream_kind_t;
+
+static const char *const kStreamNames[kQuantityOfStreams] = {
+  "clean", "corrupted", "truncated", "escapes", "noise", "oversize"
+};
+
+static uint32_t build_stream(stream_kind_t kind, uint8_t *out, uint32_t size) {
+  uint32_t length = 0;
+  _seed = 1;
+
+  if (kind == kNoise) {
+    for (; length < size; ++length) {
+      out[length] = (uint8_t)next_random();
+    }
+    return length;
+  }
+
+  while (length + 256 < size) {
+    uint8_t payload[96];
+    uint32_t payloadLength = (next_random() & 1) ? 4 : 1 + next_random() % (MAX_STRING_SIZE - 1);
+    if (kind == kOversize) {
+      payloadLength = sizeof(payload);
+    }
+    for (uint32_t i = 0; i < payloadLength; ++i) {
+      payload[i] = (kind == kEscapes) ? (uint8_t)(START_FLAG + (next_random() % 2) * (END_FLAG - START_FLAG))
+                                      : (uint8_t)next_random();
+    }
+    if (kind == kEscapes) {
+      payload[next_random() % payloadLength] = ESCAPE_FLAG;
+    }
+
+    uint32_t frameLength = put_frame(&out[length], 121 + next_random() % 21, payload, payloadLength, kind != kTruncated);
+    if (kind == kTruncated) {
+      frameLength = 1 + next_random() % frameLength;
+    }
+    length += frameLength;
+  }
+
+  if (kind == kCorrupted) {
+    for (uint32_t i = 0; i < length; i += 64) {
+      out[i + next_random() % 64] = (uint8_t)next_random();
+    }
+  }
+  return length;
+}
+
+// Decodes data kRounds times in kBurst-byte bursts and returns ns per byte.
+static double run(lumen_ctx_t *ctx, stream_t *stream, uint32_t length, uint32_t *packets) {
+  *packets = 0;
+  double start = now_ns();
+  for (uint32_t round = 0; round < kRounds; ++round) {
+    stream->position = 0;
+    while (stream->position < length) {
+      stream->burstEnd = stream->position + kBurst;
+      if (stream->burstEnd > length) {
+        stream->burstEnd = length;
+      }
+      lumen_ctx_available(ctx);
+      while (lumen_ctx_get_first_packet(ctx) != NULL) {
+        ++*packets;
+      }
+    }
+  }
+  return (now_ns() - start) / ((double)kRounds * length);
+}
+
+static double report(const char *name, const uint8_t *data, uint32_t length) {
+  static lumen_ctx_t perByte;
+  static lumen_ctx_t perSpan;
+  stream_t byteStream = { data, 0, 0 };
+  stream_t spanStream = { data, 0, 0 };
+  uint32_t bytePackets, spanPackets;
+
+  lumen_ctx_init(&perByte, discard_bytes, stream_get_byte, &byteStream);
+  lumen_ctx_init(&perSpan, discard_bytes, stream_get_byte, &spanStream);
+  lumen_ctx_set_get_bytes(&perSpan, stream_get_bytes);
+
+  double byteNs = run(&perByte, &byteStream, length, &bytePackets);
+  double spanNs = run(&perSpan, &spanStream, length, &spanPackets);
+
+  uint32_t overruns, malformed, resyncs;
+  lumen_ctx_rx_stats(&perSpan, NULL, &overruns, NULL, NULL);
+  lumen_ctx_rx_errors(&perSpan, &malformed, &resyncs);
+
+  double worstNs = (byteNs > spanNs) ? byteNs : spanNs;
+  printf("%-12s %6u B  per byte %6.2f ns/B  per span %6.2f ns/B  %6u packets  malformed %6u  resyncs %6u  overruns %6u  %.3f%% of link%s\n",
+         name, length, byteNs, spanNs, spanPackets / kRounds, malformed / kRounds, resyncs / kRounds, overruns / kRounds,
+         100.0 * worstNs / kByteTimeNs, (bytePackets != spanPackets) ? "  MISMATCH" : "");
+  return (bytePackets != spanPackets) ? -1.0 : worstNs;
+}
+
+int main(int argc, char **argv) {
+  static uint8_t data[kStreamSize];
+  double worstNs = 0.0;
+  const char *worstName = "";
+
+  for (int kind = 0; kind < kQuantityOfStreams; ++kind) {
+    uint32_t length = build_stream((stream_kind_t)kind, data, sizeof(data));
+    double ns = report(kStreamNames[kind], data, length);
+    if (ns < 0.0) {
+      return 1;
+    }
+    if (ns > worstNs) {
+      worstNs = ns;
+      worstName = kStreamNames[kind];
+    }
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    FILE *file = fopen(argv[i], "rb");
+    if (file == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+    uint32_t length = (uint32_t)fread(data, 1, sizeof(data), file);
+    fclose(file);
+    if (report(argv[i], data, length) < 0.0) {
+      return 1;
+    }
+  }
+
+  printf("worst case %.2f ns/B (%s)\n", worstNs, worstName);
+  return 0;
+}
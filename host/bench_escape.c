@@ -0,0 +1,98 @@
+// Host micro-benchmark: Lumen frame payload escaping.
+//
+// Compares lumen_escape_copy() against the original byte-at-a-time loop used
+// by lumen_write / lumen_write_variable_list. Payloads under
+// kEscapeWordMinLength take the byte loop there too, so the short cases
+// should come out even; each figure is the best of several runs.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP bench_escape.c -o bench_escape && ./bench_escape
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+static uint32_t legacy_escape_copy(uint8_t *out, const uint8_t *data, uint32_t length) {
+  uint32_t outIndex = 0;
+  for (uint16_t i = 0; i < length; i++) {
+    if (data[i] == START_FLAG || data[i] == END_FLAG || data[i] == ESCAPE_FLAG) {
+      out[outIndex] = ESCAPE_FLAG;
+      ++outIndex;
+      out[outIndex] = data[i] ^ XOR_FLAG;
+      ++outIndex;
+    } else {
+      out[outIndex] = data[i];
+      ++outIndex;
+    }
+  }
+  return outIndex;
+}
+
+typedef uint32_t (*escape_fn_t)(uint8_t *, const uint8_t *, uint32_t);
+
+static double run(escape_fn_t fn, const uint8_t *data, uint32_t length, uint32_t iterations, uint8_t *out) {
+  volatile uint32_t sink = 0;
+  double best = 0.0;
+  for (int round = 0; round < 5; ++round) {
+    double start = now_ns();
+    for (uint32_t it = 0; it < iterations; ++it) {
+      sink += fn(out, data, length);
+    }
+    double ns = (now_ns() - start) / ((double)iterations * length);
+    if (round == 0 || ns < best) {
+      best = ns;
+    }
+  }
+  (void)sink;
+  return best;
+}
+
+static void bench(const char *name, const uint8_t *data, uint32_t length) {
+  static uint8_t outLegacy[2 * 4096];
+  static uint8_t outFast[2 * 4096];
+  uint32_t iterations = (16u * 1024u * 1024u) / length;
+
+  uint32_t legacyLength = legacy_escape_copy(outLegacy, data, length);
+  uint32_t fastLength = lumen_escape_copy(outFast, data, length);
+  if (legacyLength != fastLength || memcmp(outLegacy, outFast, legacyLength) != 0) {
+    printf("%-22s MISMATCH\n", name);
+    return;
+  }
+
+  double legacyNs = run(legacy_escape_copy, data, length, iterations, outLegacy);
+  double fastNs = run(lumen_escape_copy, data, length, iterations, outFast);
+  printf("%-22s %5u B  legacy %6.3f ns/B  fast %6.3f ns/B  x%.2f\n",
+         name, length, legacyNs, fastNs, legacyNs / fastNs);
+}
+
+int main() {
+  static uint8_t buffer[4096];
+  uint32_t seed = 1;
+
+  const char *label = "Iniciar cura";
+  bench("string label", (const uint8_t *)label, (uint32_t)strlen(label) + 1);
+
+  const char *longLabel = "Aush\xc3\xa4rtung starten";
+  bench("long label", (const uint8_t *)longLabel, (uint32_t)strlen(longLabel) + 1);
+
+  int32_t s32 = 1000;
+  bench("s32 value", (const uint8_t *)&s32, sizeof(s32));
+
+  for (uint32_t i = 0; i < sizeof(buffer); ++i) {
+    seed = seed * 1103515245u + 12345u;
+    buffer[i] = (uint8_t)(seed >> 16);
+  }
+  bench("project image block", buffer, 1024);
+  bench("random 4 KiB", buffer, sizeof(buffer));
+
+  memset(buffer, 'a', sizeof(buffer));
+  bench("ascii 4 KiB", buffer, sizeof(buffer));
+
+  for (uint32_t i = 0; i < sizeof(buffer); ++i) {
+    buffer[i] = (i % 3 == 0) ? START_FLAG : (i % 3 == 1) ? END_FLAG : ESCAPE_FLAG;
+  }
+  bench("escape storm 4 KiB", buffer, sizeof(buffer));
+  return 0;
+}
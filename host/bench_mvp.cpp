@@ -0,0 +1,457 @@
+// Host benchmark suite: the firmware's hot paths, on the Arduino shim.
+//
+// Builds MVP.ino, hmi_renderer.cpp and LumenProtocol.c as the sketch does,
+// with the HMI UART as a sink, and times:
+//   encode_s32, encode_string  Lumen frame encoding, ns per byte put on the wire
+//   decode                     Lumen RX decoding of reply frames, ns per byte
+//   render_all_<lang>          a language change as applyLanguageIdx does it
+//                              (batch, HMI_RenderAll, commit, flush), us per call,
+//                              with every label different from the last render
+//   render_all_unchanged       the same language again, labels already on screen
+//   render_visible             a language change with Home on screen: only its
+//                              labels go out (HMI_RenderLanguage), us per call
+//   render_navigate            Settings opened after that change, its stale
+//                              labels rendered (HMI_SetScreen), us per call
+//   bind_lookup_runtime,       the text of one Home/Settings binding: getString and
+//   bind_lookup_static         getStringLength at run time, or the entry hmi_texts.h
+//                              resolved at compile time, ns per binding
+//   render_bindings_runtime,   Home and Settings through HMI_RenderBindings or
+//   render_bindings_static     HMI_RenderTexts (the path without pre-encoded frames),
+//                              us per call, alternating languages
+//   render_all_pack            a change to a language that only comes as a pack
+//                              (hmi_langpack), us per call: opening the pack,
+//                              reading its index and pages from SPIFFS, rendering.
+//                              Only with a pack in SPIFFS_ROOT/lang, as the build's
+//                              spiffs folder has
+//   fill_language_list         HMI_FillLanguageList, ms including its delay(2)s
+//   cure_loop, idle_loop       one loop() iteration with a cure running / idle, ns
+//
+// Results go to stdout as JSON, one result per line. Every value is a cost,
+// lower is better. With --baseline, the run is compared against an earlier
+// output and exits 1 if any result is more than --tolerance percent (default
+// 25) above it, so a regression shows before flashing:
+//   ./bench_mvp > before.json
+//   ./bench_mvp --baseline before.json
+//
+// Built by host/CMakeLists.txt; `cmake --build . --target bench` runs it and
+// writes bench_mvp.json in the build folder.
+
+#include "../MVP/MVP.ino"
+
+#include <string>
+#include <vector>
+
+#define HOST_OWN_LUMEN_WRITE  // hmi_transport.cpp is the sketch's transport
+#define HOST_OWN_LUMEN_READ
+#include "host_common.h"
+
+struct Result {
+  std::string name;
+  const char *unit;
+  double value;
+  uint32_t bytes;  // bytes written per operation, 0 when it does not apply
+};
+
+static std::vector<Result> _results;
+
+static void add(const std::string &name, const char *unit, double value, uint32_t bytes = 0) {
+  _results.push_back({ name, unit, value, bytes });
+}
+
+// ===== Encode =====
+
+static uint32_t _encoded = 0;
+
+static void count_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  (void)data;
+  _encoded += length;
+}
+
+static uint16_t no_byte(void *user) {
+  (void)user;
+  return DATA_NULL;
+}
+
+static void bench_encode() {
+  static lumen_ctx_t ctx;
+  const uint32_t writes = 200000;
+
+  lumen_ctx_init(&ctx, count_bytes, no_byte, nullptr);
+  lumen_packet_t packet = { ADDR_TIME_CURANDO, kS32 };
+  _encoded = 0;
+  double start = now_ns();
+  for (uint32_t i = 0; i < writes; ++i) {
+    packet.data._s32 = (int32_t)(i * 2654435761u);  // a new value each time, so the shadow never skips it
+    lumen_ctx_write_packet(&ctx, &packet);
+#if USE_TX_QUEUE
+    lumen_ctx_tx_flush(&ctx);
+#endif
+  }
+  add("encode_s32", "ns/B", (now_ns() - start) / _encoded, _encoded / writes);
+
+  lumen_ctx_init(&ctx, count_bytes, no_byte, nullptr);
+  lumen_packet_t text = { ADDR_TXT_CONFIG, kString };
+  memset(text.data._string, 0, sizeof(text.data._string));
+  memcpy(text.data._string, "Settings}", 9);  // '}' is ESCAPE_FLAG
+  _encoded = 0;
+  start = now_ns();
+  for (uint32_t i = 0; i < writes; ++i) {
+    text.data._string[0] = (char)('A' + i % 26);
+    lumen_ctx_write_packet(&ctx, &text);
+#if USE_TX_QUEUE
+    lumen_ctx_tx_flush(&ctx);
+#endif
+  }
+  add("encode_string", "ns/B", (now_ns() - start) / _encoded, _encoded / writes);
+}
+
+// ===== Decode =====
+
+struct Stream {
+  const uint8_t *data;
+  uint32_t length;
+  uint32_t position;
+};
+
+static uint16_t stream_get_byte(void *user) {
+  Stream *stream = (Stream *)user;
+  return (stream->position < stream->length) ? stream->data[stream->position++] : DATA_NULL;
+}
+
+static uint32_t stream_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  Stream *stream = (Stream *)user;
+  uint32_t length = stream->length - stream->position;
+  if (length > max) {
+    length = max;
+  }
+  memcpy(data, &stream->data[stream->position], length);
+  stream->position += length;
+  return length;
+}
+
+static void discard_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  (void)data;
+  (void)length;
+}
+
+// The HMI's replies: S32 events and labels, as the decoder sees them on the wire.
+static std::vector<uint8_t> reply_stream() {
+  static lumen_ctx_t encoder;
+  static std::vector<uint8_t> wire;
+  wire.clear();
+  lumen_ctx_init(&encoder, [](void *, uint8_t *data, uint32_t length) { wire.insert(wire.end(), data, data + length); },
+                 no_byte, nullptr);
+  for (uint32_t i = 0; wire.size() < 32 * 1024; ++i) {
+    lumen_packet_t packet = { (uint16_t)(ADDR_PRE_CURE_1 + i % 12), kS32 };
+    packet.data._s32 = (int32_t)(i * 40503u);
+    if (i % 3 == 0) {
+      packet.address = ADDR_TXT_LANG;
+      packet.type = kString;
+      memset(packet.data._string, 0, sizeof(packet.data._string));
+      snprintf(packet.data._string, sizeof(packet.data._string), "Lang %u", i);
+    }
+    lumen_ctx_write_packet(&encoder, &packet);
+#if USE_TX_QUEUE
+    lumen_ctx_tx_flush(&encoder);
+#endif
+  }
+  // The display sends READ frames.
+  for (size_t i = 0; i + 1 < wire.size(); ++i) {
+    if (wire[i] == START_FLAG && wire[i + 1] == WRITE_FLAG) {
+      wire[i + 1] = READ_FLAG;
+    }
+  }
+  return wire;
+}
+
+// Rewriting the command byte breaks the CRC, so with USE_CRC there is no
+// decode result; bench_decoder covers that configuration.
+static void bench_decode() {
+#if !USE_CRC
+  static lumen_ctx_t ctx;
+  std::vector<uint8_t> wire = reply_stream();
+  Stream stream = { wire.data(), (uint32_t)wire.size(), 0 };
+  const uint32_t rounds = 100;
+  uint32_t packets = 0;
+
+  lumen_ctx_init(&ctx, discard_bytes, stream_get_byte, &stream);
+  lumen_ctx_set_get_bytes(&ctx, stream_get_bytes);
+  double start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    stream.position = 0;
+    while (stream.position < stream.length) {
+      lumen_ctx_available(&ctx);
+      while (lumen_ctx_get_first_packet(&ctx) != nullptr) {
+        ++packets;
+      }
+    }
+  }
+  add("decode", "ns/B", (now_ns() - start) / ((double)rounds * stream.length));
+  if (packets == 0) {
+    fprintf(stderr, "decode: no packets came out\n");
+    exit(1);
+  }
+#endif
+}
+
+// ===== Renderer =====
+
+static const char *const kLanguageNames[] = { "en", "pt", "es", "de" };
+
+// What applyLanguageIdx does before the HMI reports its screen, without its
+// console line.
+static void render_language(Language language) {
+  lumen_batch_begin();
+  HMI_SyncLangVarToHMI(language);
+  HMI_RenderAll(language);
+  lumen_batch_commit();
+  lumen_tx_flush();
+}
+
+static void bench_render() {
+  const uint32_t rounds = 2000;
+
+  for (int language = LANG_EN; language <= LANG_DE; ++language) {
+    Language other = (Language)((language + 1) % 4);
+    double total = 0.0;
+    uint32_t bytes = 0;
+    for (uint32_t round = 0; round < rounds; ++round) {
+      render_language(other);
+      uint32_t before = HMIserial.host_bytes_written();
+      double start = now_ns();
+      render_language((Language)language);
+      total += now_ns() - start;
+      bytes = HMIserial.host_bytes_written() - before;
+    }
+    add(std::string("render_all_") + kLanguageNames[language], "us", total / rounds / 1000.0, bytes);
+  }
+
+  uint32_t before = HMIserial.host_bytes_written();
+  double start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    render_language(LANG_DE);
+  }
+  add("render_all_unchanged", "us", (now_ns() - start) / rounds / 1000.0,
+      (HMIserial.host_bytes_written() - before) / rounds);
+
+  double visible = 0.0, navigate = 0.0;
+  uint32_t visibleBytes = 0, navigateBytes = 0;
+  for (uint32_t round = 0; round < rounds; ++round) {
+    HMI_SetScreen(SCREEN_HOME);
+    before = HMIserial.host_bytes_written();
+    start = now_ns();
+    lumen_batch_begin();
+    HMI_RenderLanguage((Language)(round % 4));
+    lumen_batch_commit();
+    lumen_tx_flush();
+    visible += now_ns() - start;
+    visibleBytes = HMIserial.host_bytes_written() - before;
+
+    before = HMIserial.host_bytes_written();
+    start = now_ns();
+    HMI_SetScreen(SCREEN_SETTINGS);
+    lumen_tx_flush();
+    navigate += now_ns() - start;
+    navigateBytes = HMIserial.host_bytes_written() - before;
+  }
+  add("render_visible", "us", visible / rounds / 1000.0, visibleBytes);
+  add("render_navigate", "us", navigate / rounds / 1000.0, navigateBytes);
+  HMI_SetScreen(SCREEN_UNKNOWN);
+  render_language(LANG_DE);
+}
+
+// The texts of Home and Settings, resolved as HMI_RenderBindings does before
+// hmi_texts.h, or read from the tables it builds at compile time.
+static const size_t kHomeCount = sizeof(HOME_BINDINGS) / sizeof(HOME_BINDINGS[0]);
+static const size_t kSettingsCount = sizeof(SETTINGS_BINDINGS) / sizeof(SETTINGS_BINDINGS[0]);
+
+static void render_bindings(Language language, bool constant) {
+  lumen_batch_begin();
+  if (constant) {
+    HMI_RenderTexts(HOME_TEXTS.lang[language].items, kHomeCount);
+    HMI_RenderTexts(SETTINGS_TEXTS.lang[language].items, kSettingsCount);
+  } else {
+    HMI_RenderBindings(language, HOME_BINDINGS, kHomeCount);
+    HMI_RenderBindings(language, SETTINGS_BINDINGS, kSettingsCount);
+  }
+  lumen_batch_commit();
+  lumen_tx_flush();
+}
+
+static volatile uint32_t _sink;  // keeps the lookup loops
+
+static void bench_bindings() {
+  const uint32_t rounds = 200000;
+  uint32_t sink = 0;
+
+  double start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    Language language = (Language)(round % LANG_COUNT);
+    for (size_t i = 0; i < kSettingsCount; ++i) {
+      const char *text = getString(language, SETTINGS_BINDINGS[i].id);
+      sink += (uint32_t)(uintptr_t)text + getStringLength(language, SETTINGS_BINDINGS[i].id);
+    }
+  }
+  add("bind_lookup_runtime", "ns", (now_ns() - start) / rounds / kSettingsCount);
+
+  start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    const HmiText *texts = SETTINGS_TEXTS.lang[round % LANG_COUNT].items;
+    for (size_t i = 0; i < kSettingsCount; ++i) {
+      sink += (uint32_t)(uintptr_t)texts[i].text + texts[i].length;
+    }
+  }
+  add("bind_lookup_static", "ns", (now_ns() - start) / rounds / kSettingsCount);
+  _sink = sink;
+
+  const uint32_t renders = 2000;
+  for (int constant = 0; constant <= 1; ++constant) {
+    double total = 0.0;
+    uint32_t bytes = 0;
+    for (uint32_t round = 0; round < renders; ++round) {
+      Language language = (Language)(round % LANG_COUNT);
+      uint32_t before = HMIserial.host_bytes_written();
+      double begin = now_ns();
+      render_bindings(language, constant != 0);
+      total += now_ns() - begin;
+      bytes = HMIserial.host_bytes_written() - before;
+    }
+    add(constant ? "render_bindings_static" : "render_bindings_runtime", "us", total / renders / 1000.0, bytes);
+  }
+}
+
+static void bench_langpack() {
+  const uint32_t rounds = 200;
+
+  LangPack_Begin();
+  if (LangPack_Count() <= LANG_COUNT) {
+    return;
+  }
+  const Language pack = (Language)LANG_COUNT;
+  double total = 0.0;
+  uint32_t bytes = 0;
+  for (uint32_t round = 0; round < rounds; ++round) {
+    LangPack_Select(LANG_EN);
+    render_language(LANG_EN);
+    uint32_t before = HMIserial.host_bytes_written();
+    double start = now_ns();
+    LangPack_Select(pack);
+    render_language(pack);
+    total += now_ns() - start;
+    bytes = HMIserial.host_bytes_written() - before;
+  }
+  LangPack_Select(LANG_EN);
+  add("render_all_pack", "us", total / rounds / 1000.0, bytes);
+}
+
+static void bench_fill_language_list() {
+  const uint32_t rounds = 5;
+  uint32_t before = HMIserial.host_bytes_written();
+  uint64_t delayedBefore = shim_delayed_us();
+  double start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    HMI_FillLanguageList();
+  }
+  double totalMs = (now_ns() - start) / rounds / 1e6;
+  double delayedMs = (double)(shim_delayed_us() - delayedBefore) / rounds / 1000.0;
+  add("fill_language_list", "ms", totalMs, (HMIserial.host_bytes_written() - before) / rounds);
+  add("fill_language_list_work", "ms", totalMs - delayedMs);
+}
+
+// ===== loop() =====
+
+static void bench_loop(const char *name, bool curing) {
+  const uint32_t iterations = 200000;
+  if (curing) {
+    target_time_s = 3600;
+    startCure();
+  } else {
+    stopCure();
+  }
+  lumen_tx_flush();
+
+  uint32_t before = HMIserial.host_bytes_written();
+  double start = now_ns();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    loop();
+  }
+  add(name, "ns", (now_ns() - start) / iterations, (HMIserial.host_bytes_written() - before) / iterations);
+}
+
+// ===== Output and baseline =====
+
+static void print_results() {
+  printf("{\"suite\":\"mvp\",\"config\":{\"crc\":%s,\"ack\":%s,\"batch\":%s,\"shadow\":%s,\"tx_queue\":%s},\"results\":[\n",
+         USE_CRC ? "true" : "false", USE_ACK ? "true" : "false", USE_BATCH ? "true" : "false",
+         USE_SHADOW ? "true" : "false", USE_TX_QUEUE ? "true" : "false");
+  for (size_t i = 0; i < _results.size(); ++i) {
+    const Result &r = _results[i];
+    printf("{\"name\":\"%s\",\"unit\":\"%s\",\"value\":%.3f,\"bytes\":%u}%s\n", r.name.c_str(), r.unit, r.value, r.bytes,
+           (i + 1 < _results.size()) ? "," : "");
+  }
+  printf("]}\n");
+}
+
+// Reads back the results of an earlier run (the format print_results writes).
+static bool compare(const char *path, double tolerance) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  bool ok = true;
+  char line[256];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    char name[64];
+    double value;
+    if (sscanf(line, "{\"name\":\"%63[^\"]\",\"unit\":\"%*[^\"]\",\"value\":%lf", name, &value) != 2) {
+      continue;
+    }
+    for (const Result &r : _results) {
+      if (r.name == name && value > 0.0 && r.value > value * (1.0 + tolerance / 100.0)) {
+        fprintf(stderr, "regression: %s %.3f %s, baseline %.3f (+%.0f%%)\n", name, r.value, r.unit, value,
+                100.0 * (r.value / value - 1.0));
+        ok = false;
+      }
+    }
+  }
+  fclose(file);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  const char *baseline = nullptr;
+  double tolerance = 25.0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline = argv[++i];
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = strtod(argv[++i], nullptr);
+    } else {
+      fprintf(stderr, "usage: %s [--baseline results.json] [--tolerance percent]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  // The sketch's UART set up as setup() does, with nothing attached: a sink.
+  HMI_TransportBegin(HMIserial, HMI_BAUD, HMI_RX, HMI_TX);
+  lumen_set_schema(HMI_SCHEMA, sizeof(HMI_SCHEMA) / sizeof(HMI_SCHEMA[0]));
+
+  bench_encode();
+  bench_decode();
+  bench_render();
+  bench_bindings();
+  bench_fill_language_list();
+  bench_langpack();
+  bench_loop("cure_loop", true);
+  bench_loop("idle_loop", false);
+
+  print_results();
+  if (baseline != nullptr && !compare(baseline, tolerance)) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,171 @@
+// Host micro-benchmark: Lumen RX decoding, per byte vs per span.
+//
+// Feeds the same stream of HMI reply frames to two contexts, one pulling
+// input through getByte (one call per byte, like lumen_get_byte in the
+// sketch) and one through getBytes + the span decoder. Input arrives in
+// bursts of the given size, as it would from the UART FIFO between two
+// loop() passes. Both must decode the same packets.
+//
+// On the ESP32 each transport call is an available() / read() pair into the
+// UART driver and costs far more than here, so the calls per KiB column is
+// the number to look at for the firmware.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP bench_rx.c -o bench_rx && ./bench_rx
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+#define kStreamSize (64u * 1024u)
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t position;
+  uint32_t burstEnd;
+  uint32_t calls;
+} stream_t;
+
+static void discard_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  (void)data;
+  (void)length;
+}
+
+// Kept out of line so every byte pays for a real call, as with the
+// HMIserial.available() / read() pair behind lumen_get_byte.
+__attribute__((noinline)) static uint16_t stream_get_byte(void *user) {
+  stream_t *stream = (stream_t *)user;
+  ++stream->calls;
+  if (stream->position >= stream->burstEnd) {
+    return DATA_NULL;
+  }
+  return stream->data[stream->position++];
+}
+
+__attribute__((noinline)) static uint32_t stream_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  stream_t *stream = (stream_t *)user;
+  uint32_t length = stream->burstEnd - stream->position;
+  ++stream->calls;
+  if (length > max) {
+    length = max;
+  }
+  memcpy(data, &stream->data[stream->position], length);
+  stream->position += length;
+  return length;
+}
+
+static uint32_t put_escaped(uint8_t *out, uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    out[0] = ESCAPE_FLAG;
+    out[1] = value ^ XOR_FLAG;
+    return 2;
+  }
+  out[0] = value;
+  return 1;
+}
+
+static uint32_t put_frame(uint8_t *out, uint16_t address, const uint8_t *payload, uint32_t length) {
+  uint32_t index = 0;
+  out[index++] = START_FLAG;
+  out[index++] = READ_FLAG;
+  index += put_escaped(&out[index], address & 0xFF);
+  index += put_escaped(&out[index], address >> 8);
+  for (uint32_t i = 0; i < length; ++i) {
+    index += put_escaped(&out[index], payload[i]);
+  }
+  out[index++] = END_FLAG;
+  return index;
+}
+
+// Reply frames as the HMI sends them: s32 presets and strings, some values
+// needing escapes.
+static uint32_t build_stream(uint8_t *out, uint32_t size, uint32_t *frames) {
+  uint32_t length = 0;
+  uint32_t seed = 1;
+  *frames = 0;
+
+  while (length + 64 < size) {
+    seed = seed * 1103515245u + 12345u;
+    uint16_t address = 130 + (seed >> 16) % 12;
+    if ((seed >> 8) & 1) {
+      int32_t value = (int32_t)(seed >> 4);
+      if (((seed >> 9) & 7) == 0) {
+        value = 0x7D1213;
+      }
+      length += put_frame(&out[length], address, (const uint8_t *)&value, sizeof(value));
+    } else {
+      char text[MAX_STRING_SIZE];
+      uint32_t textLength = 1 + (seed >> 20) % (MAX_STRING_SIZE - 1);
+      for (uint32_t i = 0; i < textLength - 1; ++i) {
+        text[i] = 'a' + (char)((seed >> i) % 26);
+      }
+      text[textLength - 1] = '\0';
+      length += put_frame(&out[length], address, (const uint8_t *)text, textLength);
+    }
+    ++*frames;
+  }
+  return length;
+}
+
+// Decodes the stream rounds times and returns ns per byte. *checksum and
+// *packets describe what came out, so both paths can be compared.
+static double run(lumen_ctx_t *ctx, stream_t *stream, uint32_t length, uint32_t burst, uint32_t rounds,
+                  uint32_t *checksum, uint32_t *packets) {
+  *checksum = 0;
+  *packets = 0;
+  stream->calls = 0;
+
+  double start = now_ns();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    stream->position = 0;
+    while (stream->position < length) {
+      stream->burstEnd = stream->position + burst;
+      if (stream->burstEnd > length) {
+        stream->burstEnd = length;
+      }
+      lumen_ctx_available(ctx);
+
+      lumen_packet_t *packet = lumen_ctx_get_first_packet(ctx);
+      while (packet != NULL) {
+        *checksum = (*checksum * 31u) ^ packet->address ^ packet->data._u32;
+        ++*packets;
+        packet = lumen_ctx_get_first_packet(ctx);
+      }
+    }
+  }
+  return (now_ns() - start) / ((double)rounds * length);
+}
+
+int main() {
+  static uint8_t data[kStreamSize];
+  static lumen_ctx_t perByte;
+  static lumen_ctx_t perSpan;
+  stream_t byteStream = { data, 0, 0, 0 };
+  stream_t spanStream = { data, 0, 0, 0 };
+  uint32_t frames;
+  uint32_t length = build_stream(data, sizeof(data), &frames);
+  const uint32_t bursts[] = { 16, 64, 128, 512 };
+
+  lumen_ctx_init(&perByte, discard_bytes, stream_get_byte, &byteStream);
+  lumen_ctx_init(&perSpan, discard_bytes, stream_get_byte, &spanStream);
+  lumen_ctx_set_get_bytes(&perSpan, stream_get_bytes);
+
+  printf("stream %u B, %u frames\n", length, frames);
+  for (uint32_t i = 0; i < sizeof(bursts) / sizeof(bursts[0]); ++i) {
+    uint32_t byteChecksum, bytePackets, spanChecksum, spanPackets;
+    double byteNs = run(&perByte, &byteStream, length, bursts[i], 200, &byteChecksum, &bytePackets);
+    double spanNs = run(&perSpan, &spanStream, length, bursts[i], 200, &spanChecksum, &spanPackets);
+
+    if (byteChecksum != spanChecksum || bytePackets != spanPackets) {
+      printf("burst %4u B  MISMATCH (%u vs %u packets)\n", bursts[i], bytePackets, spanPackets);
+      return 1;
+    }
+    double kib = 200.0 * length / 1024.0;
+    printf("burst %4u B  per byte %6.2f ns/B %6.1f MB/s %5.0f calls/KiB  per span %6.2f ns/B %6.1f MB/s %5.1f calls/KiB  x%.2f\n",
+           bursts[i], byteNs, 1e3 / byteNs, byteStream.calls / kib, spanNs, 1e3 / spanNs, spanStream.calls / kib, byteNs / spanNs);
+  }
+  return 0;
+}
@@ -0,0 +1,197 @@
+// Fuzz target: Lumen RX decoder.
+//
+// Feeds the input to two contexts, one a byte at a time through getByte and
+// one through getBytes + the span decoder in chunks whose sizes come from
+// the input, reading both queues back after every burst. Aborts unless both
+// decode the same packets with the same counters, or if the decoder state
+// leaves its bounds. Under the sanitizers any write outside dataIn or the RX
+// queue is caught as well.
+//
+// libFuzzer (clang), from this folder:
+//   clang -g -O1 -fsanitize=fuzzer,address,undefined -I../MVP fuzz_decoder.c -o fuzz_decoder && ./fuzz_decoder
+// Without libFuzzer, a built-in driver replays the given files, or runs
+// generated streams of valid, damaged and random frames when given none:
+//   gcc -g -O1 -fsanitize=address,undefined -DLUMEN_FUZZ_MAIN -I../MVP fuzz_decoder.c -o fuzz_decoder && ./fuzz_decoder
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t position;
+  uint32_t burstEnd;
+  uint32_t seed;
+} source_t;
+
+static void discard_bytes(void *user, uint8_t *data, uint32_t length) {
+  (void)user;
+  (void)data;
+  (void)length;
+}
+
+static uint16_t source_get_byte(void *user) {
+  source_t *source = (source_t *)user;
+  return (source->position < source->burstEnd) ? source->data[source->position++] : DATA_NULL;
+}
+
+static uint32_t source_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  source_t *source = (source_t *)user;
+  source->seed = source->seed * 1103515245u + 12345u;
+  uint32_t length = 1 + (source->seed >> 16) % max;
+  if (length > source->burstEnd - source->position) {
+    length = source->burstEnd - source->position;
+  }
+  memcpy(data, &source->data[source->position], length);
+  source->position += length;
+  return length;
+}
+
+static void check(bool condition, const char *what) {
+  if (!condition) {
+    fprintf(stderr, "decoder mismatch: %s\n", what);
+    abort();
+  }
+}
+
+static void setup(lumen_ctx_t *ctx, source_t *source, bool spans) {
+  lumen_ctx_init(ctx, discard_bytes, source_get_byte, source);
+  if (spans) {
+    lumen_ctx_set_get_bytes(ctx, source_get_bytes);
+  }
+#if USE_COALESCE
+  lumen_ctx_coalesce(ctx, 130, 136);
+#endif
+#if USE_SCHEMA
+  static const lumen_variable_t variables[] = { { 123, kS32 }, { 126, kU16 }, { 140, kS32 }, { 141, kString } };
+  lumen_ctx_set_schema(ctx, variables, sizeof(variables) / sizeof(variables[0]));
+#endif
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static lumen_ctx_t perByte;
+  static lumen_ctx_t perSpan;
+  source_t byteSource = { data, 0, 0, 0 };
+  source_t spanSource = { data, 0, 0, size ? data[0] : 0 };
+  uint32_t seed = size ? data[size - 1] : 0;
+
+  setup(&perByte, &byteSource, false);
+  setup(&perSpan, &spanSource, true);
+
+  while (byteSource.position < size) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t burstEnd = byteSource.position + 1 + (seed >> 16) % 97;
+    if (burstEnd > size) {
+      burstEnd = size;
+    }
+    byteSource.burstEnd = burstEnd;
+    spanSource.burstEnd = burstEnd;
+
+    uint32_t byteAvailable = lumen_ctx_available(&perByte);
+    uint32_t spanAvailable = lumen_ctx_available(&perSpan);
+    check(byteAvailable == spanAvailable, "packets available");
+    check(byteSource.position == burstEnd && spanSource.position == burstEnd, "input consumed");
+    check(perByte.dataIndex <= kDataLength && perSpan.dataIndex <= kDataLength, "dataIn bounds");
+    check(perByte.quantityOfPacketsAvailable <= perByte.packetsCapacity, "queue bounds");
+
+    // Leave packets queued now and then so coalescing and drops are reached.
+    if ((seed >> 24) & 1) {
+      continue;
+    }
+    for (;;) {
+      lumen_packet_t *byte = lumen_ctx_get_first_packet(&perByte);
+      lumen_packet_t *span = lumen_ctx_get_first_packet(&perSpan);
+      check((byte == NULL) == (span == NULL), "queue length");
+      if (byte == NULL) {
+        break;
+      }
+      check(byte->address == span->address && byte->type == span->type, "packet header");
+      check(memcmp(&byte->data, &span->data, sizeof(byte->data)) == 0, "packet payload");
+    }
+  }
+
+  uint32_t byteStats[6], spanStats[6];
+  lumen_ctx_rx_stats(&perByte, &byteStats[0], &byteStats[1], &byteStats[2], &byteStats[3]);
+  lumen_ctx_rx_errors(&perByte, &byteStats[4], &byteStats[5]);
+  lumen_ctx_rx_stats(&perSpan, &spanStats[0], &spanStats[1], &spanStats[2], &spanStats[3]);
+  lumen_ctx_rx_errors(&perSpan, &spanStats[4], &spanStats[5]);
+  check(memcmp(byteStats, spanStats, sizeof(byteStats)) == 0, "counters");
+  return 0;
+}
+
+#if defined(LUMEN_FUZZ_MAIN)
+static uint32_t _seed = 1;
+
+static uint32_t next_random() {
+  _seed = _seed * 1103515245u + 12345u;
+  return _seed >> 8;
+}
+
+// Mostly well-formed reply frames, then damaged: bytes flipped, frames cut,
+// flags and escapes sprinkled in, runs of noise.
+static uint32_t generate(uint8_t *out, uint32_t size) {
+  uint32_t length = 0;
+  while (length + 80 < size) {
+    uint32_t kind = next_random() % 8;
+    if (kind == 0) {
+      for (uint32_t i = next_random() % 32; i > 0; --i) {
+        out[length++] = (uint8_t)next_random();
+      }
+      continue;
+    }
+    out[length++] = START_FLAG;
+    out[length++] = (kind == 1) ? (uint8_t)next_random() : READ_FLAG;
+    uint32_t payload = (kind == 2) ? 40 + next_random() % 30 : next_random() % 20;
+    for (uint32_t i = 0; i < 2 + payload; ++i) {
+      uint8_t value = (kind == 3) ? (uint8_t)(START_FLAG + next_random() % 2 * (END_FLAG - START_FLAG)) : (uint8_t)next_random();
+      if (i == 0) {
+        value = (uint8_t)(121 + next_random() % 24);
+      } else if (i == 1) {
+        value = 0;
+      }
+      if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+        out[length++] = ESCAPE_FLAG;
+        value ^= XOR_FLAG;
+      }
+      out[length++] = value;
+    }
+    if (kind != 4) {
+      out[length++] = END_FLAG;
+    }
+    if (kind == 5) {
+      out[length - 1 - next_random() % 4] ^= (uint8_t)(1 << next_random() % 8);
+    }
+  }
+  return length;
+}
+
+int main(int argc, char **argv) {
+  static uint8_t data[4096];
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) {
+      FILE *file = fopen(argv[i], "rb");
+      if (file == NULL) {
+        perror(argv[i]);
+        return 1;
+      }
+      size_t length = fread(data, 1, sizeof(data), file);
+      fclose(file);
+      LLVMFuzzerTestOneInput(data, length);
+    }
+    printf("OK %d inputs replayed\n", argc - 1);
+    return 0;
+  }
+
+  const uint32_t inputs = 20000;
+  for (uint32_t i = 0; i < inputs; ++i) {
+    uint32_t length = generate(data, 100 + next_random() % (sizeof(data) - 100));
+    LLVMFuzzerTestOneInput(data, length);
+  }
+  printf("OK %u generated inputs, per-byte and per-span decoders agree\n", inputs);
+  return 0;
+}
+#endif
@@ -0,0 +1,255 @@
+// Build step: pre-encodes the static HMI labels into ready-to-send frames.
+//
+// Every binding in hmi_bindings.h is rendered for each language of
+// smartcure_translations.h through the real Lumen encoder, and the escaped
+// frame bytes are written to MVP/hmi_frames.h as const data (flash on the
+// ESP32). HMI_RenderHome/HMI_RenderSettings then only copy those bytes out.
+// The report on stderr lists the frame bytes per language and the encode time
+// the pre-encoded path saves on this host.
+//
+// Rerun after changing hmi_bindings.h, the translations or USE_CRC:
+//   g++ -O2 -I../MVP -x c ../MVP/LumenProtocol.c -x c++ gen_hmi_frames.cpp -o gen_hmi_frames
+//   ./gen_hmi_frames > ../MVP/hmi_frames.h
+//   ./gen_hmi_frames --check ../MVP/hmi_frames.h
+// --check writes nothing, skips the report and exits 1 if the header is stale.
+//
+// Built by host/CMakeLists.txt: every build runs the check, and the
+// translations target rewrites the header after smartcure_translations.h.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "hmi_bindings.h"
+#define HOST_OWN_LUMEN_WRITE  // lumen_write_bytes below captures the frames
+#include "host_common.h"
+
+static std::vector<uint8_t> captured;
+
+extern "C" void lumen_write_bytes(uint8_t *data, uint32_t length) {
+  captured.insert(captured.end(), data, data + length);
+}
+
+struct Screen {
+  const char *name;
+  const HmiBinding *bindings;
+  size_t count;
+};
+
+static const Screen SCREENS[] = {
+  { "HOME", HOME_BINDINGS, sizeof(HOME_BINDINGS) / sizeof(HOME_BINDINGS[0]) },
+  { "SETTINGS", SETTINGS_BINDINGS, sizeof(SETTINGS_BINDINGS) / sizeof(SETTINGS_BINDINGS[0]) },
+};
+static const size_t SCREEN_COUNT = sizeof(SCREENS) / sizeof(SCREENS[0]);
+
+static const Language LANGUAGES[] = { LANG_EN, LANG_PT, LANG_ES, LANG_DE };
+static const char *LANGUAGE_NAMES[] = { "EN", "PT", "ES", "DE" };
+static const size_t LANGUAGE_COUNT = sizeof(LANGUAGES) / sizeof(LANGUAGES[0]);
+
+struct Encoded {
+  uint16_t addr;
+  uint16_t offset;
+  uint16_t length;  // of the frame on the wire
+  uint16_t size;    // of the payload: the text and its terminator
+  uint32_t hash;
+  const char *text;
+};
+
+static void forget_sent_values() {
+#if USE_SHADOW
+  lumen_shadow_invalidate_all();
+#endif
+}
+
+static void drain() {
+#if USE_TX_QUEUE
+  lumen_tx_flush();
+#endif
+}
+
+// Same path HMI_WriteString takes at runtime.
+static void write_runtime(uint16_t addr, const char *text) {
+  const size_t len = strlen(text) + 1;
+  if (len <= MAX_STRING_SIZE) {
+    lumen_packet_t p = { addr, kString };
+    memset(p.data._string, 0, sizeof(p.data._string));
+    memcpy(p.data._string, text, len);
+    lumen_write_packet(&p);
+  } else {
+    lumen_write(addr, (uint8_t *)text, (uint32_t)len);
+  }
+}
+
+// The header as generated, written out or compared at the end.
+static std::string _out;
+
+static void emit(const char *format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  _out += buffer;
+}
+
+static void emit_c_string(const char *text) {
+  _out += '"';
+  for (const char *c = text; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      _out += '\\';
+    }
+    _out += *c;
+  }
+  _out += '"';
+}
+
+static bool read_file(const char *path, std::string &content) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  char buffer[4096];
+  size_t n;
+  content.clear();
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content.append(buffer, n);
+  }
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *check = nullptr;
+  if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+    check = argv[2];
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [--check header] > hmi_frames.h\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> data;
+  std::vector<Encoded> frames[LANGUAGE_COUNT][SCREEN_COUNT];
+
+  for (size_t l = 0; l < LANGUAGE_COUNT; ++l) {
+    for (size_t s = 0; s < SCREEN_COUNT; ++s) {
+      for (size_t b = 0; b < SCREENS[s].count; ++b) {
+        const HmiBinding &binding = SCREENS[s].bindings[b];
+        const char *text = getString(LANGUAGES[l], binding.id);
+
+        forget_sent_values();
+        captured.clear();
+        write_runtime(binding.addr, text);
+        drain();
+
+        Encoded e;
+        e.addr = binding.addr;
+        e.offset = (uint16_t)data.size();
+        e.length = (uint16_t)captured.size();
+        e.size = (uint16_t)(strlen(text) + 1);
+#if USE_SHADOW
+        e.hash = lumen_shadow_hash((const uint8_t *)text, e.size);
+#else
+        e.hash = 0;
+#endif
+        e.text = text;
+
+        // Screens share some labels; keep one copy of each distinct frame.
+        for (size_t other = 0; other < s; ++other) {
+          for (const Encoded &o : frames[l][other]) {
+            if (o.length == e.length && memcmp(&data[o.offset], captured.data(), e.length) == 0) {
+              e.offset = o.offset;
+            }
+          }
+        }
+        if (e.offset == data.size()) {
+          data.insert(data.end(), captured.begin(), captured.end());
+        }
+        frames[l][s].push_back(e);
+      }
+    }
+  }
+
+  emit("// Generated by host/gen_hmi_frames.cpp from hmi_bindings.h and\n");
+  emit("// smartcure_translations.h. Do not edit; rerun the generator instead.\n");
+  emit("#pragma once\n");
+  emit("#include <stdint.h>\n");
+  emit("#include \"LumenProtocol.h\"\n\n");
+  emit("#define HMI_FRAMES_USE_CRC %s\n", USE_CRC ? "true" : "false");
+  emit("#define HMI_FRAMES_AVAILABLE ((HMI_FRAMES_USE_CRC == USE_CRC) && !USE_ACK)\n\n");
+  emit("// length: frame on the wire; size and hash: its payload, for the shadow\n");
+  emit("struct HmiEncodedFrame { uint16_t addr; uint16_t offset; uint16_t length; uint16_t size; uint32_t hash; };\n\n");
+
+  emit("static const uint8_t HMI_FRAME_DATA[%zu] = {", data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    emit("%s0x%02x,", (i % 16) ? " " : "\n  ", data[i]);
+  }
+  emit("\n};\n");
+
+  for (size_t s = 0; s < SCREEN_COUNT; ++s) {
+    emit("\nstatic const HmiEncodedFrame HMI_FRAMES_%s[%zu][%zu] = {\n", SCREENS[s].name, LANGUAGE_COUNT, SCREENS[s].count);
+    for (size_t l = 0; l < LANGUAGE_COUNT; ++l) {
+      emit("  { // %s\n", LANGUAGE_NAMES[l]);
+      for (const Encoded &e : frames[l][s]) {
+        emit("    { %u, %u, %u, %u, 0x%08xu }, // ", e.addr, e.offset, e.length, e.size, e.hash);
+        emit_c_string(e.text);
+        emit("\n");
+      }
+      emit("  },\n");
+    }
+    emit("};\n");
+  }
+
+  if (check != nullptr) {
+    std::string current;
+    if (!read_file(check, current) || current != _out) {
+      fprintf(stderr, "gen_hmi_frames: %s is out of date; run the translations target\n", check);
+      return 1;
+    }
+    return 0;
+  }
+  fwrite(_out.data(), 1, _out.size(), stdout);
+
+  const int repetitions = 20000;
+  fprintf(stderr, "lang  bytes sent  runtime encode  pre-encoded  saved\n");
+  for (size_t l = 0; l < LANGUAGE_COUNT; ++l) {
+    size_t bytes = 0;
+    for (size_t s = 0; s < SCREEN_COUNT; ++s) {
+      for (const Encoded &e : frames[l][s]) {
+        bytes += e.length;
+      }
+    }
+
+    double start = now_ns();
+    for (int r = 0; r < repetitions; ++r) {
+      forget_sent_values();
+      for (size_t s = 0; s < SCREEN_COUNT; ++s) {
+        for (size_t b = 0; b < SCREENS[s].count; ++b) {
+          write_runtime(SCREENS[s].bindings[b].addr, getString(LANGUAGES[l], SCREENS[s].bindings[b].id));
+          captured.clear();
+          drain();
+        }
+      }
+    }
+    double runtimeNs = (now_ns() - start) / repetitions;
+
+    start = now_ns();
+    for (int r = 0; r < repetitions; ++r) {
+      forget_sent_values();
+      for (size_t s = 0; s < SCREEN_COUNT; ++s) {
+        for (const Encoded &e : frames[l][s]) {
+          lumen_write_encoded(e.addr, e.hash, e.size, &data[e.offset], e.length);
+          captured.clear();
+          drain();
+        }
+      }
+    }
+    double encodedNs = (now_ns() - start) / repetitions;
+
+    fprintf(stderr, "%-4s  %10zu  %11.0f ns  %8.0f ns  %4.0f%%\n", LANGUAGE_NAMES[l], bytes, runtimeNs, encodedNs,
+            100.0 * (runtimeNs - encodedNs) / runtimeNs);
+  }
+  fprintf(stderr, "%zu bytes of frame data in flash\n", data.size());
+  return 0;
+}
@@ -0,0 +1,759 @@
+// Build step: generates MVP/smartcure_translations.h from the translation
+// files in the repository root (en.json, pt.json, es.json, de.json).
+//
+// Each file is a flat JSON object of key -> text. The first file is the
+// reference: every other language must have exactly its keys, or the build
+// fails. A key becomes a StringId by upper-casing it and turning '.' into '_'
+// ("home.startCure" -> ID_HOME_STARTCURE). Its number comes from the GROUPS
+// table below: the key's section gets a base, and the keys of a section are
+// numbered from it in the reference file's order. A new section needs a
+// line there.
+//
+// The header keeps the layout getString() reads: a compact index per id
+// through the group tables, and per language the offset, byte length and
+// "fit" of each string. Fit is the byte length cut on a UTF-8 character
+// boundary so that the text plus its NUL fits a MAX_STRING_SIZE HMI string,
+// the variant HMI_WriteListItem sends. The strings of all languages share one
+// blob: identical strings, and strings that end another one, are stored once.
+// The generator fails if the result would take more flash than one blob per
+// language without that sharing.
+//
+// With --packs, it also writes one language pack per file, DIR/<code>.lpk,
+// which hmi_langpack.cpp loads from SPIFFS at run time. Files given with
+// --extra only become packs: languages the image does not carry. --pseudo
+// CODE adds a pseudo-localized pack of the reference ("[Séttíñgs]"), to see
+// on the display which labels are translated and how longer ones fit. A pack
+// is, in little endian:
+//   0   "LPK1"
+//   4   u32 STR_LAYOUT_HASH of the header it was made for
+//   8   u32 text hash; equal to LANG_TEXT_HASH of a built-in language when
+//       the pack holds the same text, so the firmware can skip it
+//   12  u16 string count (STR_COUNT), u16 page count
+//   16  char code[4], the file name without .lpk ("de")
+//   20  char name[20], the language's name in the reference file
+//       (settings.language.<code>) cut to fit the HMI, NUL-padded
+//   40  u16 page size (kPageSize), u16 reserved
+//   44  count x { u16 offset, u8 length, u8 fit }, then the pages
+// No string crosses a page, so a page read into RAM serves its strings
+// in place.
+//
+//   ./gen_translations en.json pt.json es.json de.json > ../MVP/smartcure_translations.h
+//   ./gen_translations --packs ../MVP/lang en.json ... > ../MVP/smartcure_translations.h
+//   ./gen_translations --packs out --extra fr.json --pseudo qps en.json ... > /dev/null
+//   ./gen_translations --check ../MVP/smartcure_translations.h [--packs ../MVP/lang] en.json ...
+// --check writes nothing and exits 1 if the header or a pack is stale.
+//
+// Built by host/CMakeLists.txt: every build runs the check, and
+// `cmake --build . --target translations` rewrites the header and the packs
+// in MVP/lang, then MVP/hmi_frames.h (gen_hmi_frames) from the new labels.
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "LumenProtocolConfiguration.h"
+
+// Key prefix -> first StringId. The longest matching prefix wins, and
+// prefixes with the same base share its numbering; "" takes the keys without
+// a section (txt_config, ...).
+struct Group {
+  const char *prefix;
+  unsigned base;
+};
+
+static const Group GROUPS[] = {
+  { "home.", 100 },
+  { "admin.", 200 },
+  { "settings.", 250 },
+  { "cure.selection.", 300 },
+  { "cure.process.", 350 },
+  { "outputs.", 400 },
+  { "resins.", 450 },
+  { "manufacturer.", 500 },
+  { "resin.", 550 },
+  { "common.", 600 },
+  { "", 600 },
+};
+
+// Ids of a group are base .. base + kGroupSpan - 1, which getStringIndex()
+// relies on.
+static const unsigned kIdBase = 100;
+static const unsigned kGroupSpan = 50;
+
+// Pack pages; a string and its NUL (at most 256 bytes) always fit one.
+static const size_t kPageSize = 256;
+static const size_t kPackHeaderSize = 44;
+
+struct Language {
+  std::string code;  // "EN"
+  std::string path;
+  std::vector<std::pair<std::string, std::string>> texts;  // in file order
+  std::map<std::string, std::string> byKey;
+};
+
+static void fail(const char *format, const char *a = "", const char *b = "") {
+  fprintf(stderr, "gen_translations: ");
+  fprintf(stderr, format, a, b);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+// ===== JSON (a flat object of strings is all these files are) =====
+
+struct Parser {
+  const std::string &text;
+  const char *path;
+  size_t at;
+
+  void skip_space() {
+    while (at < text.size() && strchr(" \t\r\n", text[at]) != nullptr) {
+      ++at;
+    }
+  }
+
+  void expect(char c) {
+    skip_space();
+    if (at >= text.size() || text[at] != c) {
+      char what[2] = { c, 0 };
+      fail("%s: expected '%s'", path, what);
+    }
+    ++at;
+  }
+
+  void put_utf8(std::string &out, unsigned code) {
+    if (code < 0x80) {
+      out += (char)code;
+    } else if (code < 0x800) {
+      out += (char)(0xC0 | (code >> 6));
+      out += (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out += (char)(0xE0 | (code >> 12));
+      out += (char)(0x80 | ((code >> 6) & 0x3F));
+      out += (char)(0x80 | (code & 0x3F));
+    } else {
+      out += (char)(0xF0 | (code >> 18));
+      out += (char)(0x80 | ((code >> 12) & 0x3F));
+      out += (char)(0x80 | ((code >> 6) & 0x3F));
+      out += (char)(0x80 | (code & 0x3F));
+    }
+  }
+
+  unsigned hex4() {
+    if (at + 4 > text.size()) {
+      fail("%s: truncated \\u escape", path);
+    }
+    unsigned code = (unsigned)strtoul(text.substr(at, 4).c_str(), nullptr, 16);
+    at += 4;
+    return code;
+  }
+
+  std::string string() {
+    expect('"');
+    std::string out;
+    while (at < text.size() && text[at] != '"') {
+      char c = text[at++];
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (at >= text.size()) {
+        break;
+      }
+      c = text[at++];
+      switch (c) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+          unsigned code = hex4();
+          if (code >= 0xD800 && code < 0xDC00 && text.compare(at, 2, "\\u") == 0) {
+            at += 2;
+            code = 0x10000 + ((code - 0xD800) << 10) + (hex4() - 0xDC00);
+          }
+          put_utf8(out, code);
+          break;
+        }
+        default: out += c; break;  // \" \\ \/
+      }
+    }
+    expect('"');
+    return out;
+  }
+};
+
+static bool read_file(const std::string &path, std::string &text) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  char chunk[4096];
+  size_t n;
+  text.clear();
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    text.append(chunk, n);
+  }
+  fclose(file);
+  return true;
+}
+
+static void load(Language &language) {
+  std::string text;
+  if (!read_file(language.path, text)) {
+    fail("cannot open %s", language.path.c_str());
+  }
+
+  Parser parser = { text, language.path.c_str(), 0 };
+  parser.expect('{');
+  parser.skip_space();
+  if (parser.at < text.size() && text[parser.at] == '}') {
+    return;
+  }
+  for (;;) {
+    std::string key = parser.string();
+    parser.expect(':');
+    std::string value = parser.string();
+    if (language.byKey.count(key) != 0) {
+      fail("%s: key \"%s\" appears twice", language.path.c_str(), key.c_str());
+    }
+    if (value.find('\0') != std::string::npos) {
+      fail("%s: \"%s\" contains a NUL", language.path.c_str(), key.c_str());
+    }
+    language.texts.push_back({ key, value });
+    language.byKey[key] = value;
+    parser.skip_space();
+    if (parser.at < text.size() && text[parser.at] == ',') {
+      ++parser.at;
+      continue;
+    }
+    parser.expect('}');
+    return;
+  }
+}
+
+// ===== Layout =====
+
+struct Id {
+  std::string key;
+  std::string name;
+  unsigned value;
+};
+
+static std::string id_name(const std::string &key) {
+  std::string name = "ID_";
+  for (char c : key) {
+    name += (c == '.') ? '_' : (char)toupper((unsigned char)c);
+  }
+  return name;
+}
+
+static const Group &group_of(const std::string &key) {
+  const Group *best = nullptr;
+  for (const Group &g : GROUPS) {
+    if (key.compare(0, strlen(g.prefix), g.prefix) == 0 && (best == nullptr || strlen(g.prefix) > strlen(best->prefix))) {
+      best = &g;
+    }
+  }
+  if (best == nullptr) {
+    fail("no group for key \"%s\"; add its section to GROUPS", key.c_str());
+  }
+  return *best;
+}
+
+// Bytes of text that fit a MAX_STRING_SIZE string with its NUL, without
+// splitting a UTF-8 sequence.
+static size_t fit_length(const std::string &text) {
+  size_t fit = text.size();
+  if (fit + 1 <= MAX_STRING_SIZE) {
+    return fit;
+  }
+  fit = MAX_STRING_SIZE - 1;
+  while (fit > 0 && ((unsigned char)text[fit] & 0xC0) == 0x80) {
+    --fit;
+  }
+  return fit;
+}
+
+// One blob for every string: the longest strings go in first, and a string
+// that is the tail of one already stored points into it.
+struct Blob {
+  std::string data;
+  std::vector<std::string> stored;  // in order, for the output
+  std::map<std::string, size_t> offsets;
+
+  void build(std::vector<std::string> all) {
+    std::sort(all.begin(), all.end(), [](const std::string &a, const std::string &b) {
+      return (a.size() != b.size()) ? a.size() > b.size() : a < b;
+    });
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    for (const std::string &text : all) {
+      size_t found = std::string::npos;
+      for (size_t i = 0; i < stored.size() && found == std::string::npos; ++i) {
+        const std::string &s = stored[i];
+        if (s.size() >= text.size() && s.compare(s.size() - text.size(), text.size(), text) == 0) {
+          found = offsets[s] + s.size() - text.size();
+        }
+      }
+      if (found == std::string::npos) {
+        found = data.size();
+        data += text;
+        data += '\0';
+        stored.push_back(text);
+      }
+      offsets[text] = found;
+    }
+  }
+};
+
+// FNV-1a over the ids, so a pack made for other StringIds is refused.
+static uint32_t layout_hash(const std::vector<Id> &ids) {
+  uint32_t hash = 2166136261u;
+  for (const Id &id : ids) {
+    std::string line = id.name + "=" + std::to_string(id.value) + "\n";
+    for (unsigned char c : line) {
+      hash = (hash ^ c) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+// FNV-1a over a language's strings in id order.
+static uint32_t text_hash(const Language &language, const std::vector<Id> &ids) {
+  uint32_t hash = 2166136261u;
+  for (const Id &id : ids) {
+    const std::string &text = language.byKey.at(id.key);
+    for (size_t i = 0; i <= text.size(); ++i) {
+      hash = (hash ^ (unsigned char)text.c_str()[i]) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+static void put16(std::string &out, size_t value) {
+  out += (char)(value & 0xFF);
+  out += (char)((value >> 8) & 0xFF);
+}
+
+static void put32(std::string &out, uint32_t value) {
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+// One language's pack: identical strings once, none across a page.
+static std::string make_pack(const Language &language, const Language &reference, const std::vector<Id> &ids,
+                             uint32_t hash) {
+  std::string pages, entries;
+  std::map<std::string, size_t> offsets;
+  for (const Id &id : ids) {
+    const std::string &text = language.byKey.at(id.key);
+    if (offsets.count(text) == 0) {
+      if (pages.size() % kPageSize + text.size() + 1 > kPageSize) {
+        pages.append(kPageSize - pages.size() % kPageSize, '\0');
+      }
+      offsets[text] = pages.size();
+      pages += text;
+      pages += '\0';
+    }
+    if (offsets[text] > 0xFFFF) {
+      fail("the %s pack no longer fits 16-bit offsets", language.path.c_str());
+    }
+    put16(entries, offsets[text]);
+    entries += (char)text.size();
+    entries += (char)fit_length(text);
+  }
+  pages.append((kPageSize - pages.size() % kPageSize) % kPageSize, '\0');
+
+  std::string code, name;
+  for (char c : language.code) {
+    code += (char)tolower((unsigned char)c);
+  }
+  auto found = reference.byKey.find("settings.language." + code);
+  name = (found != reference.byKey.end()) ? found->second : language.code;
+  name = name.substr(0, fit_length(name));
+  if (code.size() > 3 || name.size() > 19) {
+    fail("%s: code or name too long for a pack", language.path.c_str());
+  }
+
+  std::string pack = "LPK1";
+  put32(pack, hash);
+  put32(pack, text_hash(language, ids));
+  put16(pack, ids.size());
+  put16(pack, pages.size() / kPageSize);
+  pack += code;
+  pack.append(4 - code.size(), '\0');
+  pack += name;
+  pack.append(20 - name.size(), '\0');
+  put16(pack, kPageSize);
+  put16(pack, 0);
+  if (pack.size() != kPackHeaderSize) {
+    fail("pack header size mismatch");
+  }
+  return pack + entries + pages;
+}
+
+// With check, compares instead of writing; false when they differ.
+static bool write_or_check(const std::string &path, const std::string &content, bool check) {
+  if (check) {
+    std::string current;
+    if (!read_file(path, current) || current != content) {
+      fprintf(stderr, "gen_translations: %s is out of date; run the translations target\n", path.c_str());
+      return false;
+    }
+    return true;
+  }
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr || fwrite(content.data(), 1, content.size(), file) != content.size()) {
+    fail("cannot write %s", path.c_str());
+  }
+  fclose(file);
+  return true;
+}
+
+// The reference's text with its vowels and some consonants accented, in
+// brackets, so untranslated and overflowing labels stand out.
+static Language pseudo_language(const Language &reference, const char *code) {
+  static const char *const kFrom = "aeiouncAEIOUNC";
+  static const char *const kTo[] = { "á", "é", "í", "ó", "ú", "ñ", "ç", "Á", "É", "Í", "Ó", "Ú", "Ñ", "Ç" };
+  Language pseudo;
+  pseudo.path = std::string("--pseudo ") + code;
+  for (const char *c = code; *c; ++c) {
+    pseudo.code += (char)toupper((unsigned char)*c);
+  }
+  for (const auto &text : reference.texts) {
+    std::string out = "[";
+    for (char c : text.second) {
+      const char *at = strchr(kFrom, c);
+      out += (at != nullptr && c != '\0') ? kTo[at - kFrom] : std::string(1, c);
+    }
+    out += "]";
+    pseudo.texts.push_back({ text.first, out });
+    pseudo.byKey[text.first] = out;
+  }
+  return pseudo;
+}
+
+static std::string c_string(const std::string &text) {
+  std::string out = "\"";
+  for (unsigned char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += (char)c;
+    } else if (c < 0x20 || c == 0x7F) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\%03o", c);
+      out += escaped;
+    } else {
+      out += (char)c;
+    }
+  }
+  return out + "\"";
+}
+
+// ===== Output =====
+
+static std::string _out;
+
+static void emit(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static void emit(const char *format, ...) {
+  char line[1024];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  // The header keeps the sketch folder's CRLF line endings.
+  for (const char *c = line; *c; ++c) {
+    if (*c == '\n') {
+      _out += '\r';
+    }
+    _out += *c;
+  }
+}
+
+static void emit_numbers(const char *type, const std::string &name, const std::vector<size_t> &values) {
+  emit("static constexpr %s %s[STR_COUNT] = {", type, name.c_str());
+  for (size_t i = 0; i < values.size(); ++i) {
+    emit("%s%zu,", (i % 16) ? " " : "\n  ", values[i]);
+  }
+  emit("\n};\n");
+}
+
+int main(int argc, char **argv) {
+  const char *check = nullptr;
+  const char *packs = nullptr;
+  std::vector<const char *> pseudoCodes;
+  std::vector<Language> languages, extras;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+      check = argv[++i];
+    } else if (strcmp(argv[i], "--packs") == 0 && i + 1 < argc) {
+      packs = argv[++i];
+    } else if (strcmp(argv[i], "--pseudo") == 0 && i + 1 < argc) {
+      pseudoCodes.push_back(argv[++i]);
+    } else if (argv[i][0] != '-' || (strcmp(argv[i], "--extra") == 0 && i + 1 < argc)) {
+      bool extra = (argv[i][0] == '-');
+      Language language;
+      language.path = argv[extra ? ++i : i];
+      std::string base = language.path.substr(language.path.find_last_of('/') + 1);
+      base = base.substr(0, base.find('.'));
+      for (char c : base) {
+        language.code += (char)toupper((unsigned char)c);
+      }
+      (extra ? extras : languages).push_back(language);
+    } else {
+      languages.clear();
+      break;
+    }
+  }
+  if (languages.empty() || (packs == nullptr && (!extras.empty() || !pseudoCodes.empty()))) {
+    fprintf(stderr, "usage: %s [--check header] [--packs dir [--extra xx.json] [--pseudo code]] en.json pt.json ...\n",
+            argv[0]);
+    return 2;
+  }
+
+  for (Language &language : languages) {
+    load(language);
+  }
+  for (Language &language : extras) {
+    load(language);
+  }
+  for (const char *code : pseudoCodes) {
+    extras.push_back(pseudo_language(languages[0], code));
+  }
+
+  // Every language has the reference's keys, and nothing else.
+  const Language &reference = languages[0];
+  std::vector<const Language *> everyLanguage;
+  for (const Language &language : languages) {
+    everyLanguage.push_back(&language);
+  }
+  for (const Language &language : extras) {
+    everyLanguage.push_back(&language);
+  }
+  bool complete = true;
+  for (const Language *each : everyLanguage) {
+    const Language &language = *each;
+    for (const auto &text : reference.texts) {
+      if (language.byKey.count(text.first) == 0) {
+        fprintf(stderr, "gen_translations: %s: missing \"%s\"\n", language.path.c_str(), text.first.c_str());
+        complete = false;
+      }
+    }
+    for (const auto &text : language.texts) {
+      if (reference.byKey.count(text.first) == 0) {
+        fprintf(stderr, "gen_translations: %s: \"%s\" is not in %s\n", language.path.c_str(), text.first.c_str(),
+                reference.path.c_str());
+        complete = false;
+      }
+    }
+  }
+  if (!complete) {
+    return 1;
+  }
+
+  // Numbering and the dense index.
+  std::vector<Id> ids;
+  std::map<unsigned, unsigned> next;  // group base -> next id
+  std::map<std::string, std::string> names;
+  for (const auto &text : reference.texts) {
+    const Group &group = group_of(text.first);
+    unsigned value = next.count(group.base) ? next[group.base] : group.base;
+    if (value >= group.base + kGroupSpan || (group.base - kIdBase) % kGroupSpan != 0) {
+      fail("group of \"%s\" is full or misaligned", text.first.c_str());
+    }
+    next[group.base] = value + 1;
+    Id id = { text.first, id_name(text.first), value };
+    if (names.count(id.name) != 0) {
+      fail("\"%s\" and \"%s\" give the same StringId", names[id.name].c_str(), text.first.c_str());
+    }
+    names[id.name] = text.first;
+    ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end(), [](const Id &a, const Id &b) { return a.value < b.value; });
+  const unsigned groupCount = (ids.back().value - kIdBase) / kGroupSpan + 1;
+  std::vector<size_t> groupFirst(groupCount, 0), groupSize(groupCount, 0);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    unsigned group = (ids[i].value - kIdBase) / kGroupSpan;
+    if (groupSize[group]++ == 0) {
+      groupFirst[group] = i;
+    }
+  }
+  for (unsigned g = 0; g < groupCount; ++g) {
+    if (groupSize[g] == 0) {
+      groupFirst[g] = (g > 0) ? groupFirst[g - 1] + groupSize[g - 1] : 0;
+    }
+  }
+  const char *indexType = (ids.size() <= 0xFF) ? "uint8_t" : "uint16_t";
+
+  std::vector<std::string> all;
+  for (const Language &language : languages) {
+    for (const Id &id : ids) {
+      const std::string &text = language.byKey.at(id.key);
+      if (text.size() > 0xFF) {
+        fail("\"%s\" is longer than 255 bytes in %s", id.key.c_str(), language.path.c_str());
+      }
+      all.push_back(text);
+    }
+  }
+  Blob blob;
+  blob.build(all);
+  if (blob.data.size() > 0xFFFF) {
+    fail("the strings no longer fit 16-bit offsets");
+  }
+
+  // Flash taken on the ESP32 (32-bit pointers): the layout generated here,
+  // one blob per language with the same index tables, and the old sparse
+  // pointer tables.
+  const size_t count = ids.size(), langs = languages.size();
+  const size_t indexBytes = 2 * groupCount * (ids.size() <= 0xFF ? 1 : 2);
+  size_t plainBlobs = 0;
+  for (const std::string &text : all) {
+    plainBlobs += text.size() + 1;
+  }
+  const size_t generated = blob.data.size() + indexBytes + langs * count * (2 + 1 + 1) + langs * 16;
+  const size_t plain = plainBlobs + indexBytes + langs * count * (2 + 1) + langs * 12;
+  const size_t sparse = plainBlobs + langs * (ids.back().value - kIdBase + 1) * 4;
+  fprintf(stderr, "%zu strings x %zu languages, %zu distinct in a %zu byte blob\n", count, langs, blob.stored.size(),
+          blob.data.size());
+  fprintf(stderr, "flash: %zu B generated, %zu B one blob per language, %zu B sparse pointer tables\n", generated, plain,
+          sparse);
+  if (generated > plain) {
+    fail("the shared blob costs more than separate ones; check the sharing");
+  }
+
+  // ===== The header =====
+  emit("// Generated by host/gen_translations.cpp from");
+  for (size_t l = 0; l < langs; ++l) {
+    std::string path = languages[l].path.substr(languages[l].path.find_last_of('/') + 1);
+    emit(" %s%s", path.c_str(), (l + 1 < langs) ? "," : ".");
+  }
+  emit("\n// Do not edit; change the JSON files and rerun the generator.\n");
+  emit("#pragma once\n#include <stdint.h>\nextern \"C\" {\n");
+  emit("typedef enum {");
+  for (size_t l = 0; l < langs; ++l) {
+    emit(" LANG_%s=%zu,", languages[l].code.c_str(), l);
+  }
+  // The enum's range has to cover them.
+  emit(" LANG_PACK_LAST=15 } Language;  // indexes past the built-in ones: languages that only come as packs\n");
+  emit("typedef enum {\n");
+  for (const Id &id : ids) {
+    emit("  %s = %u,\n", id.name.c_str(), id.value);
+  }
+  emit("} StringId;\n\n");
+
+  emit("// Dense layout: the StringIds come in groups of STR_ID_SPAN from STR_ID_BASE,\n");
+  emit("// each filled from its base, so an id maps to a compact index through two\n");
+  emit("// small tables. All languages share one blob of NUL-terminated strings; per\n");
+  emit("// language and index there is a 16-bit offset into it, the byte length\n");
+  emit("// (without the NUL) and the length cut to fit a STR_FIT_SIZE HMI string.\n");
+  emit("// Tables and lookups are constexpr (C++11), so a constant id resolves at\n");
+  emit("// compile time (hmi_texts.h).\n");
+  emit("#define LANG_COUNT %zu\n", langs);
+  emit("#define STR_ID_BASE %u\n", kIdBase);
+  emit("#define STR_ID_SPAN %u\n", kGroupSpan);
+  emit("#define STR_GROUPS %u\n", groupCount);
+  emit("#define STR_COUNT %zu\n", count);
+  emit("#define STR_FIT_SIZE %d\n", MAX_STRING_SIZE);
+  emit("#define STR_LAYOUT_HASH 0x%08xu  // language packs carry the hash of the ids they were made for\n\n",
+       layout_hash(ids));
+  emit("static constexpr uint32_t LANG_TEXT_HASH[LANG_COUNT] = {");
+  for (size_t l = 0; l < langs; ++l) {
+    emit(" 0x%08xu%s", text_hash(languages[l], ids), (l + 1 < langs) ? "," : " };\n");
+  }
+  emit("static constexpr const char* LANG_CODES[LANG_COUNT] = {");
+  for (size_t l = 0; l < langs; ++l) {
+    std::string code;
+    for (char c : languages[l].code) {
+      code += (char)tolower((unsigned char)c);
+    }
+    emit(" \"%s\"%s", code.c_str(), (l + 1 < langs) ? "," : " };\n");
+  }
+  emit("static constexpr %s STR_GROUP_FIRST[STR_GROUPS] = {", indexType);
+  for (unsigned g = 0; g < groupCount; ++g) {
+    emit(" %zu%s", groupFirst[g], (g + 1 < groupCount) ? "," : " };\n");
+  }
+  emit("static constexpr %s STR_GROUP_SIZE[STR_GROUPS] = {", indexType);
+  for (unsigned g = 0; g < groupCount; ++g) {
+    emit(" %zu%s", groupSize[g], (g + 1 < groupCount) ? "," : " };\n");
+  }
+
+  emit("\nstatic constexpr char STR_BLOB[%zu] =\n", blob.data.size());
+  for (size_t i = 0; i < blob.stored.size(); ++i) {
+    // The literal's own NUL ends the last string.
+    emit("  %s%s\n", c_string(blob.stored[i]).c_str(), (i + 1 < blob.stored.size()) ? " \"\\0\"" : ";");
+  }
+
+  for (const Language &language : languages) {
+    std::vector<size_t> offsets, lengths, fits;
+    for (const Id &id : ids) {
+      const std::string &text = language.byKey.at(id.key);
+      offsets.push_back(blob.offsets.at(text));
+      lengths.push_back(text.size());
+      fits.push_back(fit_length(text));
+    }
+    emit("\n");
+    emit_numbers("uint16_t", "STR_OFFSET_" + language.code, offsets);
+    emit_numbers("uint8_t", "STR_LENGTH_" + language.code, lengths);
+    emit_numbers("uint8_t", "STR_FIT_" + language.code, fits);
+  }
+
+  emit("\ntypedef struct { const char* blob; const uint16_t* offset; const uint8_t* length; const uint8_t* fit; } StringPack;\n");
+  emit("static constexpr StringPack STR_PACKS[LANG_COUNT] = {\n");
+  for (const Language &language : languages) {
+    const char *c = language.code.c_str();
+    emit("  { STR_BLOB, STR_OFFSET_%s, STR_LENGTH_%s, STR_FIT_%s },\n", c, c, c);
+  }
+  emit("};\n\n");
+
+  // Single-return bodies: C++11 constexpr functions allow nothing else.
+  emit("static constexpr unsigned _strGroup(StringId id) { return ((unsigned)id - STR_ID_BASE) / STR_ID_SPAN; }\n");
+  emit("static constexpr unsigned _strSlot(StringId id) { return ((unsigned)id - STR_ID_BASE) %% STR_ID_SPAN; }\n");
+  emit("// Compact index of an id, or -1 when the id has no string.\n");
+  emit("static constexpr int getStringIndex(StringId id) {\n");
+  emit("  return (_strGroup(id) < STR_GROUPS && _strSlot(id) < STR_GROUP_SIZE[_strGroup(id)])\n");
+  emit("      ? STR_GROUP_FIRST[_strGroup(id)] + (int)_strSlot(id) : -1;\n");
+  emit("}\n");
+  emit("static constexpr const StringPack* _pack(Language lang) {\n");
+  emit("  return &STR_PACKS[((unsigned)lang < LANG_COUNT) ? lang : LANG_%s];\n", reference.code.c_str());
+  emit("}\n");
+  emit("static constexpr const char* getString(Language lang, StringId id) {\n");
+  emit("  return (getStringIndex(id) < 0) ? \"\" : _pack(lang)->blob + _pack(lang)->offset[getStringIndex(id)];\n");
+  emit("}\n");
+  emit("// strlen(getString(lang, id)), from the table.\n");
+  emit("static constexpr uint8_t getStringLength(Language lang, StringId id) {\n");
+  emit("  return (getStringIndex(id) < 0) ? 0 : _pack(lang)->length[getStringIndex(id)];\n");
+  emit("}\n");
+  emit("// Leading bytes of getString(lang, id) that fit a STR_FIT_SIZE string with\n");
+  emit("// its NUL, cut on a character boundary; the whole length when it fits.\n");
+  emit("static constexpr uint8_t getStringFit(Language lang, StringId id) {\n");
+  emit("  return (getStringIndex(id) < 0) ? 0 : _pack(lang)->fit[getStringIndex(id)];\n");
+  emit("}\n\n");
+  emit("} // extern \"C\"\n");
+
+  bool current = true;
+  if (packs != nullptr) {
+    for (const Language *each : everyLanguage) {
+      const Language &language = *each;
+      std::string code;
+      for (char c : language.code) {
+        code += (char)tolower((unsigned char)c);
+      }
+      std::string pack = make_pack(language, reference, ids, layout_hash(ids));
+      current &= write_or_check(std::string(packs) + "/" + code + ".lpk", pack, check != nullptr);
+      fprintf(stderr, "%s.lpk: %zu B\n", code.c_str(), pack.size());
+    }
+  }
+  if (check != nullptr) {
+    current &= write_or_check(check, _out, true);
+    return current ? 0 : 1;
+  }
+  fwrite(_out.data(), 1, _out.size(), stdout);
+  return 0;
+}
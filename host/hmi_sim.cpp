@@ -0,0 +1,743 @@
+// Host tool: the UnicView HMI, simulated on a pty.
+//
+// Plays the display end of the link for the firmware built for this host
+// (hmi_transport.cpp's pty backend). It speaks the Lumen framing selected in
+// LumenProtocolConfiguration.h (CRC and ACK included), keeps the variables of
+// user_variables.h (121..141) and the items of list 126, answers the
+// firmware's READ requests and ACKs its writes. Both directions are paced at
+// --baud, so the firmware sees the wire time of a real UART and its writes
+// back up in the pty as they would in the UART FIFO; --baud 0 turns pacing off.
+//
+// A script plays the user (one command per line, # starts a comment):
+//   boot          wait for the firmware's boot burst
+//   wait MS       keep serving the link for MS
+//   screen N      the display switches to screen N  (121 = N)
+//   lang N        language selector                 (123 = N)
+//   list N        language picked in the list       (126 = N)
+//   preset I S    preset I (1..7) edited to S       (130 + I - 1 = S)
+//   select S      preset of S seconds selected      (138 = S)
+//   start / pause / stop                            (140 = 1 / 3 / 0)
+//   set A V       variable A holds V, as if edited earlier; no event is sent
+//   reboot MS     the display restarts: deaf for MS, then every variable
+//                 and list item back to its power-on value
+//   dump          print the variable table
+//   expect A V    fail the run unless variable A holds V (a number, or
+//                 "text" for a label)
+// Without --script, a session covering every event kind is played.
+//
+// A READ asks for quantity consecutive variables. Each is answered with its
+// own reply frame, the only reply the vendor's parser accepts (one address,
+// one value). The vendor documents no other reply for quantity > 1, so
+// --read-single answers only the first variable of such a READ. The
+// firmware must still end up with every value, by asking for the rest alone.
+//
+// Each event is sent the way the display sends it, as a READ frame carrying
+// the new value. The firmware's answer is collected until --quiet ms pass
+// without a frame, or until it writes a variable it already wrote in this
+// answer: that is a periodic update (the cure's time and progress), not part
+// of the answer. Per event it reports:
+//   round trip   first byte of the event on the wire to the end of the first
+//                frame the firmware sent back
+//   render       the same, to the end of the last frame of the answer
+//   wire         time both directions' bytes take at --baud; render minus
+//                wire is the firmware's share
+// With --json every row is printed as a JSON object instead.
+//
+// Build from this folder:
+//   g++ -O2 -I../MVP hmi_sim.cpp -o hmi_sim
+// Run it, then start the firmware on the pty it prints (or pass --pty to use
+// one the firmware created):
+//   ./hmi_sim [--baud 115200] [--quiet 50] [--script file] [--json] [--read-single] [--pty path]
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "user_variables.h"
+
+#define kFirstAddress ADDR_MAIN_SCREEN
+#define kLastAddress ADDR_PROGRESS_PERMILLE
+#define kQuantityOfVariables (kLastAddress - kFirstAddress + 1)
+#define kMaxFrame 256u
+#define kBootTimeoutMs 10000.0
+#define kReplyTimeoutMs 1000.0
+
+struct Variable {
+  const char *name;
+  uint16_t address;
+  lumen_data_type_t type;
+  int32_t value;
+  std::string text;
+};
+
+static Variable _variables[kQuantityOfVariables];
+static std::string _list[MAX_LIST_SIZE];
+
+// One measurement window: an event and the frames the firmware sent for it.
+struct Window {
+  std::string event;
+  double start;       // first byte of the event on the wire; boot: first byte received
+  double firstFrame;  // end of the first frame received, -1 if none yet
+  double lastFrame;
+  uint32_t frames;
+  uint32_t bytesIn;
+  uint32_t bytesOut;
+  uint32_t reads;
+  std::set<uint32_t> written;  // address << 16 | list index, of each write in the answer
+  bool endOnRepeat;            // off for boot, which writes some variables twice
+  bool done;
+};
+
+struct Pending {
+  std::vector<uint8_t> bytes;
+  double at;  // when its last byte leaves the wire
+};
+
+static int _fd = -1;
+static int _peerFd = -1;
+static uint32_t _baud = 115200;
+static double _quietMs = 50.0;
+static bool _json = false;
+static bool _readSingle = false;
+static bool _offline = false;  // rebooting: frames from the firmware go unheard
+
+static double _rxFree = 0.0;  // the firmware-to-display wire is busy until then
+static double _txFree = 0.0;  // the display-to-firmware wire is busy until then
+static std::deque<Pending> _tx;
+static Window _window;
+static bool _measuring = false;
+
+// Decoder state for frames from the firmware
+static uint8_t _frame[kMaxFrame];
+static uint32_t _frameLength = 0;
+static bool _inFrame = false;
+static bool _escaped = false;
+static bool _overrun = false;
+static uint32_t _frameBytes = 0;  // on the wire, escapes and flags included
+
+static uint32_t _framesIn = 0;
+static uint32_t _background = 0;  // frames outside any window (cure ticks)
+static uint32_t _malformed = 0;
+static uint32_t _resyncs = 0;
+static uint32_t _acks = 0;
+static uint32_t _failed = 0;
+
+static double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static double wire_ms(uint32_t bytes) {
+  return _baud ? bytes * 10000.0 / _baud : 0.0;
+}
+
+static Variable *find_variable(uint16_t address) {
+  if (address < kFirstAddress || address > kLastAddress) {
+    return nullptr;
+  }
+  Variable *variable = &_variables[address - kFirstAddress];
+  return variable->name ? variable : nullptr;
+}
+
+static void init_variables() {
+#define SIM_VARIABLE(name, address, type) _variables[(address) - kFirstAddress] = { #name, address, type, 0, "" };
+  HMI_VARIABLES(SIM_VARIABLE)
+#undef SIM_VARIABLE
+}
+
+#if USE_CRC
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t length) {
+  while (length--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+  }
+  return crc;
+}
+#endif
+
+static void put_escaped(std::vector<uint8_t> &out, uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    out.push_back(ESCAPE_FLAG);
+    out.push_back(value ^ XOR_FLAG);
+  } else {
+    out.push_back(value);
+  }
+}
+
+// Queues a frame behind whatever is still on the display-to-firmware wire
+// and returns when its first byte goes out.
+static double send_frame(uint8_t command, uint16_t address, const uint8_t *payload, uint32_t length, double after) {
+  std::vector<uint8_t> body = { command, (uint8_t)(address & 0xFF), (uint8_t)(address >> 8) };
+  body.insert(body.end(), payload, payload + length);
+
+  Pending pending;
+  pending.bytes.push_back(START_FLAG);
+  for (uint8_t value : body) {
+    put_escaped(pending.bytes, value);
+  }
+#if USE_CRC
+  uint16_t crc = crc16(0xFFFF, body.data(), (uint32_t)body.size());
+  put_escaped(pending.bytes, crc >> 8);
+  put_escaped(pending.bytes, crc & 0xFF);
+#endif
+  pending.bytes.push_back(END_FLAG);
+
+  double start = after;
+  if (start < _txFree) {
+    start = _txFree;
+  }
+  pending.at = start + wire_ms((uint32_t)pending.bytes.size());
+  _txFree = pending.at;
+  if (_measuring) {
+    _window.bytesOut += (uint32_t)pending.bytes.size();
+  }
+  _tx.push_back(pending);
+  return start;
+}
+
+// The pty delivers at once, so a frame is handed over when its last byte
+// would have reached the firmware.
+static void flush_tx(double now) {
+  while (!_tx.empty() && _tx.front().at <= now) {
+    const std::vector<uint8_t> &bytes = _tx.front().bytes;
+    size_t written = 0;
+    while (written < bytes.size()) {
+      ssize_t n = write(_fd, bytes.data() + written, bytes.size() - written);
+      if (n < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+          continue;
+        }
+        perror("write");
+        exit(1);
+      }
+      written += (size_t)n;
+    }
+    _tx.pop_front();
+  }
+}
+
+static void store_write(uint16_t address, const uint8_t *payload, uint32_t length) {
+  if (address == ADDR_LIST_LANG) {
+    if (length >= 2) {
+      uint16_t index = (uint16_t)(payload[0] | (payload[1] << 8));
+      if (index < MAX_LIST_SIZE) {
+        _list[index].assign((const char *)payload + 2, strnlen((const char *)payload + 2, length - 2));
+      }
+    }
+    return;
+  }
+  Variable *variable = find_variable(address);
+  if (variable == nullptr) {
+    return;
+  }
+  if (variable->type == kString) {
+    variable->text.assign((const char *)payload, strnlen((const char *)payload, length));
+  } else if (length == 4) {
+    variable->value = (int32_t)(payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24));
+  }
+}
+
+static void answer_read(uint16_t address, uint8_t quantity, double at) {
+  if (_readSingle && quantity > 1) {
+    quantity = 1;
+  }
+  for (uint16_t i = 0; i < quantity; ++i) {
+    Variable *variable = find_variable(address + i);
+    if (variable == nullptr) {
+      continue;
+    }
+    if (variable->type == kString) {
+      send_frame(READ_FLAG, variable->address, (const uint8_t *)variable->text.c_str(),
+                 (uint32_t)variable->text.size() + 1, at);
+    } else {
+      uint8_t value[4];
+      for (int b = 0; b < 4; ++b) {
+        value[b] = (uint8_t)((uint32_t)variable->value >> (8 * b));
+      }
+      send_frame(READ_FLAG, variable->address, value, sizeof(value), at);
+    }
+  }
+}
+
+// A complete frame from the firmware, unescaped, ended at time at.
+static void handle_frame(double at) {
+  if (_offline) {
+    return;
+  }
+  uint32_t length = _frameLength;
+  if (_overrun || length < 3 || (_frame[0] != WRITE_FLAG && _frame[0] != READ_FLAG)) {
+    ++_malformed;
+    return;
+  }
+  uint16_t address = (uint16_t)(_frame[1] | (_frame[2] << 8));
+
+#if USE_CRC
+  if (length < 5) {
+    ++_malformed;
+    return;
+  }
+  length -= 2;
+  uint16_t expected = (uint16_t)((_frame[length] << 8) | _frame[length + 1]);
+  // List writes leave the item index out of the CRC.
+  uint16_t crc;
+  if (_frame[0] == WRITE_FLAG && address == ADDR_LIST_LANG && length >= 5) {
+    crc = crc16(crc16(0xFFFF, _frame, 3), &_frame[5], length - 5);
+  } else {
+    crc = crc16(0xFFFF, _frame, length);
+  }
+  if (crc != expected) {
+    ++_malformed;
+    return;
+  }
+#endif
+
+  ++_framesIn;
+  if (_measuring && _frame[0] == WRITE_FLAG) {
+    uint32_t key = (uint32_t)address << 16;
+    if (address == ADDR_LIST_LANG && length >= 5) {
+      key |= (uint32_t)(_frame[3] | (_frame[4] << 8));
+    }
+    if (!_window.written.insert(key).second && _window.endOnRepeat) {
+      _window.done = true;
+      _measuring = false;
+    }
+  }
+  if (_measuring) {
+    _window.bytesIn += _frameBytes;
+    if (_window.firstFrame < 0) {
+      _window.firstFrame = at;
+    }
+    _window.lastFrame = at;
+    ++_window.frames;
+  } else {
+    ++_background;
+  }
+
+  if (_frame[0] == READ_FLAG) {
+    if (length >= 4) {
+      if (_measuring) {
+        ++_window.reads;
+      }
+      answer_read(address, _frame[3], at);
+    }
+    return;
+  }
+
+#if USE_ACK
+  if (length < 5) {
+    ++_malformed;
+    return;
+  }
+  length -= 2;
+  uint8_t slot = _frame[length];
+  send_frame(ACK_FLAG, slot, nullptr, 0, at);
+  ++_acks;
+#endif
+  store_write(address, &_frame[3], length - 3);
+}
+
+static void decode(uint8_t value, double at) {
+  if (value == START_FLAG) {
+    if (_inFrame) {
+      ++_resyncs;
+    }
+    _inFrame = true;
+    _escaped = false;
+    _overrun = false;
+    _frameLength = 0;
+    _frameBytes = 1;
+    return;
+  }
+  if (!_inFrame) {
+    return;
+  }
+
+  ++_frameBytes;
+  if (value == END_FLAG) {
+    _inFrame = false;
+    if (_escaped) {
+      ++_malformed;
+    } else {
+      handle_frame(at);
+    }
+  } else if (value == ESCAPE_FLAG) {
+    _escaped = true;
+  } else {
+    if (_escaped) {
+      value ^= XOR_FLAG;
+      _escaped = false;
+    }
+    if (_frameLength < kMaxFrame) {
+      _frame[_frameLength++] = value;
+    } else {
+      _overrun = true;
+    }
+  }
+}
+
+// Reads what the firmware wrote, at most what the wire carries in about a
+// millisecond, and stamps each byte with when it finishes arriving.
+static void receive(double now) {
+  uint8_t buffer[512];
+  uint32_t chunk = _baud ? _baud / 10000u : sizeof(buffer);
+  if (chunk < 1) {
+    chunk = 1;
+  } else if (chunk > sizeof(buffer)) {
+    chunk = sizeof(buffer);
+  }
+  ssize_t n = read(_fd, buffer, chunk);
+  if (n <= 0) {
+    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+      perror("read");
+      exit(1);
+    }
+    return;
+  }
+
+  double start = (_rxFree > now) ? _rxFree : now;
+  if (_measuring && _window.start < 0) {
+    _window.start = start;
+  }
+  for (ssize_t i = 0; i < n; ++i) {
+    decode(buffer[i], start + wire_ms((uint32_t)i + 1));
+  }
+  _rxFree = start + wire_ms((uint32_t)n);
+}
+
+// Serves the link until deadline, or, with quiet set, until the window has
+// seen a frame and then quiet ms without one.
+static void serve(double deadline, bool quiet) {
+  for (;;) {
+    double now = now_ms();
+    flush_tx(now);
+    if (quiet && (_window.done || (_window.firstFrame >= 0 && now - _window.lastFrame >= _quietMs && now >= _rxFree))) {
+      return;
+    }
+    if (now >= deadline) {
+      return;
+    }
+
+    double wake = deadline;
+    if (quiet && _window.firstFrame >= 0 && _window.lastFrame + _quietMs < wake) {
+      wake = _window.lastFrame + _quietMs;
+    }
+    if (!_tx.empty() && _tx.front().at < wake) {
+      wake = _tx.front().at;
+    }
+    bool wireFree = now >= _rxFree;
+    if (!wireFree && _rxFree < wake) {
+      wake = _rxFree;
+    }
+
+    struct pollfd pfd = { _fd, (short)(wireFree ? POLLIN : 0), 0 };
+    double wait = wake - now;
+    struct timespec timeout = { (time_t)(wait / 1000.0), (long)(fmod(wait, 1000.0) * 1e6) };
+    if (ppoll(&pfd, 1, &timeout, nullptr) > 0 && (pfd.revents & POLLIN)) {
+      receive(now_ms());
+    }
+  }
+}
+
+static void open_window(const std::string &event, double start, bool endOnRepeat) {
+  _window = Window();
+  _window.event = event;
+  _window.start = start;
+  _window.endOnRepeat = endOnRepeat;
+  _window.firstFrame = -1.0;
+  _window.lastFrame = -1.0;
+  _measuring = true;
+}
+
+static void close_window() {
+  _measuring = false;
+  const Window &w = _window;
+  double origin = w.start;
+  double wire = wire_ms(w.bytesIn + w.bytesOut);
+
+  if (_json) {
+    printf("{\"event\":\"%s\",\"round_trip_ms\":%.3f,\"render_ms\":%.3f,\"wire_ms\":%.3f,"
+           "\"frames\":%u,\"reads\":%u,\"bytes_in\":%u,\"bytes_out\":%u}\n",
+           w.event.c_str(), w.firstFrame >= 0 ? w.firstFrame - origin : -1.0,
+           w.firstFrame >= 0 ? w.lastFrame - origin : -1.0, wire, w.frames, w.reads, w.bytesIn, w.bytesOut);
+  } else if (w.firstFrame < 0) {
+    printf("%-12s no answer                                     wire %7.2f ms\n", w.event.c_str(), wire);
+  } else {
+    printf("%-12s round trip %7.2f ms  render %8.2f ms  wire %7.2f ms  %3u frames  %3u reads  %5u B in  %3u B out\n",
+           w.event.c_str(), w.firstFrame - origin, w.lastFrame - origin, wire, w.frames, w.reads, w.bytesIn,
+           w.bytesOut);
+  }
+  fflush(stdout);
+}
+
+// Sends a user event and measures the firmware's answer to it.
+static void user_event(const std::string &name, uint16_t address, int32_t value) {
+  Variable *variable = find_variable(address);
+  if (variable != nullptr) {
+    variable->value = value;
+  }
+  uint8_t payload[4];
+  for (int b = 0; b < 4; ++b) {
+    payload[b] = (uint8_t)((uint32_t)value >> (8 * b));
+  }
+
+  double now = now_ms();
+  open_window(name, 0.0, true);
+  _window.start = send_frame(READ_FLAG, address, payload, sizeof(payload), now);
+  serve(_window.start + kReplyTimeoutMs, true);
+  close_window();
+}
+
+static void dump() {
+  for (uint32_t i = 0; i < kQuantityOfVariables; ++i) {
+    const Variable &v = _variables[i];
+    if (v.name == nullptr) {
+      continue;
+    }
+    if (_json) {
+      if (v.type == kString) {
+        printf("{\"address\":%u,\"name\":\"%s\",\"text\":\"%s\"}\n", v.address, v.name, v.text.c_str());
+      } else {
+        printf("{\"address\":%u,\"name\":\"%s\",\"value\":%d}\n", v.address, v.name, v.value);
+      }
+    } else if (v.type == kString) {
+      printf("  %3u %-18s \"%s\"\n", v.address, v.name, v.text.c_str());
+    } else {
+      printf("  %3u %-18s %d\n", v.address, v.name, v.value);
+    }
+  }
+  for (uint32_t i = 0; i < MAX_LIST_SIZE; ++i) {
+    if (!_list[i].empty() && !_json) {
+      printf("  %3u[%u] %-15s \"%s\"\n", ADDR_LIST_LANG, i, "list_lang", _list[i].c_str());
+    }
+  }
+}
+
+static void expect(const char *line, uint32_t number) {
+  unsigned address = 0;
+  int used = 0;
+  if (sscanf(line, "%*s %u %n", &address, &used) < 1 || used == 0) {
+    fprintf(stderr, "script line %u: expect needs an address and a value\n", number);
+    ++_failed;
+    return;
+  }
+  const char *value = line + used;
+  Variable *variable = find_variable((uint16_t)address);
+  if (variable == nullptr) {
+    fprintf(stderr, "script line %u: no variable at %u\n", number, address);
+    ++_failed;
+    return;
+  }
+
+  bool ok;
+  std::string got;
+  if (value[0] == '"') {
+    const char *end = strchr(value + 1, '"');
+    std::string wanted(value + 1, end ? (size_t)(end - value - 1) : strlen(value + 1));
+    got = "\"" + variable->text + "\"";
+    ok = variable->text == wanted;
+  } else {
+    got = std::to_string(variable->value);
+    ok = variable->type != kString && variable->value == (int32_t)strtol(value, nullptr, 10);
+  }
+  if (!ok) {
+    fprintf(stderr, "script line %u: %s (%u) is %s, expected %s\n", number, variable->name, address, got.c_str(), value);
+    ++_failed;
+  }
+}
+
+static const char *const kDefaultScript =
+    "boot\n"
+    "list 0\n"
+    "list 2\n"
+    "list 3\n"
+    "lang 1\n"
+    "screen 2\n"
+    "preset 1 8\n"
+    "preset 2 2\n"
+    "select 2\n"
+    "start\n"
+    "wait 1200\n"
+    "pause\n"
+    "wait 300\n"
+    "start\n"
+    "wait 1500\n"
+    "select 3\n"
+    "start\n"
+    "wait 500\n"
+    "stop\n"
+    "dump\n";
+
+static bool run_command(const char *line, uint32_t number) {
+  char command[16];
+  int a = 0, b = 0;
+  int fields = sscanf(line, "%15s %d %d", command, &a, &b);
+  if (fields <= 0 || command[0] == '#') {
+    return true;
+  }
+
+  std::string name = line;
+  size_t comment = name.find('#');
+  if (comment != std::string::npos) {
+    name.erase(comment);
+  }
+  while (!name.empty() && (name.back() == '\n' || name.back() == '\r' || name.back() == ' ')) {
+    name.pop_back();
+  }
+
+  if (strcmp(command, "boot") == 0) {
+    open_window("boot", -1.0, false);
+    serve(now_ms() + kBootTimeoutMs, true);
+    close_window();
+  } else if (strcmp(command, "wait") == 0 && fields == 2) {
+    serve(now_ms() + a, false);
+  } else if (strcmp(command, "screen") == 0 && fields == 2) {
+    user_event(name, ADDR_MAIN_SCREEN, a);
+  } else if (strcmp(command, "lang") == 0 && fields == 2) {
+    user_event(name, ADDR_LANG_VAR, a);
+  } else if (strcmp(command, "list") == 0 && fields == 2) {
+    user_event(name, ADDR_LIST_LANG, a);
+  } else if (strcmp(command, "preset") == 0 && fields == 3 && a >= 1 && a <= 7) {
+    user_event(name, (uint16_t)(ADDR_PRE_CURE_1 + a - 1), b);
+  } else if (strcmp(command, "select") == 0 && fields == 2) {
+    user_event(name, ADDR_SELECTED_PRE_CURE, a);
+  } else if (strcmp(command, "start") == 0) {
+    user_event(name, ADDR_TIMER_START_STOP, 1);
+  } else if (strcmp(command, "pause") == 0) {
+    user_event(name, ADDR_TIMER_START_STOP, 3);
+  } else if (strcmp(command, "stop") == 0) {
+    user_event(name, ADDR_TIMER_START_STOP, 0);
+  } else if (strcmp(command, "set") == 0 && fields == 3 && find_variable((uint16_t)a) != nullptr) {
+    find_variable((uint16_t)a)->value = b;
+  } else if (strcmp(command, "reboot") == 0 && fields == 2) {
+    _offline = true;
+    serve(now_ms() + a, false);
+    init_variables();
+    for (std::string &item : _list) {
+      item.clear();
+    }
+    _offline = false;
+  } else if (strcmp(command, "dump") == 0) {
+    dump();
+  } else if (strcmp(command, "expect") == 0) {
+    expect(name.c_str(), number);
+  } else {
+    fprintf(stderr, "script line %u: cannot parse \"%s\"\n", number, name.c_str());
+    return false;
+  }
+  return true;
+}
+
+static bool open_link(const char *path) {
+  if (path != nullptr) {
+    _fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_fd < 0) {
+      perror(path);
+      return false;
+    }
+  } else {
+    _fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_fd < 0 || grantpt(_fd) != 0 || unlockpt(_fd) != 0) {
+      perror("posix_openpt");
+      return false;
+    }
+    path = ptsname(_fd);
+    // Held open so the pty survives until the firmware opens it.
+    _peerFd = open(path, O_RDWR | O_NOCTTY);
+  }
+
+  struct termios tio;
+  int rawFd = (_peerFd >= 0) ? _peerFd : _fd;
+  if (tcgetattr(rawFd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(rawFd, TCSANOW, &tio);
+  }
+  fprintf(stderr, "HMI on %s, %u baud, CRC %s, ACK %s\n", path, _baud, USE_CRC ? "on" : "off", USE_ACK ? "on" : "off");
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *ptyPath = nullptr;
+  const char *scriptPath = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+      _baud = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--quiet") == 0 && i + 1 < argc) {
+      _quietMs = strtod(argv[++i], nullptr);
+    } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+      scriptPath = argv[++i];
+    } else if (strcmp(argv[i], "--pty") == 0 && i + 1 < argc) {
+      ptyPath = argv[++i];
+    } else if (strcmp(argv[i], "--json") == 0) {
+      _json = true;
+    } else if (strcmp(argv[i], "--read-single") == 0) {
+      _readSingle = true;
+    } else {
+      fprintf(stderr, "usage: %s [--baud N] [--quiet MS] [--script file] [--json] [--read-single] [--pty path]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  init_variables();
+  if (!open_link(ptyPath)) {
+    return 1;
+  }
+
+  std::string script = kDefaultScript;
+  if (scriptPath != nullptr) {
+    FILE *file = fopen(scriptPath, "r");
+    if (file == nullptr) {
+      perror(scriptPath);
+      return 1;
+    }
+    script.clear();
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+      script += buffer;
+    }
+    fclose(file);
+  }
+
+  uint32_t number = 0;
+  size_t position = 0;
+  while (position < script.size()) {
+    size_t end = script.find('\n', position);
+    if (end == std::string::npos) {
+      end = script.size();
+    }
+    std::string line = script.substr(position, end - position);
+    position = end + 1;
+    if (!run_command(line.c_str(), ++number)) {
+      return 1;
+    }
+  }
+
+  if (_json) {
+    printf("{\"frames\":%u,\"background\":%u,\"acks\":%u,\"malformed\":%u,\"resyncs\":%u,\"failed\":%u}\n",
+           _framesIn, _background, _acks, _malformed, _resyncs, _failed);
+  } else {
+    printf("frames %u (%u outside events), acks %u, malformed %u, resyncs %u, failed expectations %u\n", _framesIn,
+           _background, _acks, _malformed, _resyncs, _failed);
+  }
+
+  close(_fd);
+  if (_peerFd >= 0) {
+    close(_peerFd);
+  }
+  return (_malformed != 0 || _failed != 0) ? 1 : 0;
+}
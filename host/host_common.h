@@ -0,0 +1,49 @@
+// Shared by the protocol tools of this folder: a monotonic clock and the
+// default Lumen transport.
+//
+// Include it after LumenProtocol.c (or LumenProtocol.h). The default
+// transport discards what is written and never has a byte to read, which is
+// all a tool needs when it drives its own lumen_ctx_t or only encodes. A tool
+// that feeds or captures the global transport defines HOST_OWN_LUMEN_WRITE
+// (lumen_write_bytes) or HOST_OWN_LUMEN_READ (lumen_get_byte and
+// lumen_get_bytes) before the include and supplies those itself.
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include "LumenProtocol.h"
+
+static inline double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HOST_OWN_LUMEN_WRITE
+void lumen_write_bytes(uint8_t *data, uint32_t length) {
+  (void)data;
+  (void)length;
+}
+#endif
+
+#ifndef HOST_OWN_LUMEN_READ
+uint16_t lumen_get_byte() {
+  return DATA_NULL;
+}
+
+uint32_t lumen_get_bytes(uint8_t *data, uint32_t max) {
+  (void)data;
+  (void)max;
+  return 0;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
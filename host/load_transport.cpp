@@ -0,0 +1,148 @@
+// Host load test: HMI transport (pty backend) behind a busy loop().
+//
+// Opens a pty pair through HMI_TransportOpenPty(NULL) and plays the display
+// on the other end: a thread sends timer_start_stop (140) events paced at
+// 115200 baud, each carrying its send time. The main thread acts as loop():
+// it "renders" (sleeps) for a fixed time, then decodes everything that
+// arrived. For each render time it reports events decoded against sent,
+// bytes the RX ring lost, its peak fill, how long bursts waited in it, and
+// the end-to-end latency from the display's write to the decoded packet.
+//
+// The Lumen queue gets a pool large enough for the longest render, so any
+// loss shown is the transport's.
+//
+// Build and run from this folder:
+//   g++ -O2 -pthread -I../MVP -x c ../MVP/LumenProtocol.c -x c++ ../MVP/hmi_transport.cpp load_transport.cpp -o load_transport
+//   ./load_transport
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "LumenProtocol.h"
+#include "hmi_transport.h"
+
+#define kEvents 400u
+#define kBaud 115200u
+#define kAddress 140
+
+static uint32_t now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+static uint32_t put_escaped(uint8_t *out, uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    out[0] = ESCAPE_FLAG;
+    out[1] = value ^ XOR_FLAG;
+    return 2;
+  }
+  out[0] = value;
+  return 1;
+}
+
+static bool _displayDone = false;  // __atomic: written by the display thread
+
+// The display: one event frame per slot of wire time, stamped when written.
+static void *display(void *) {
+  int fd = open(HMI_TransportPtyName(), O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    perror(HMI_TransportPtyName());
+    __atomic_store_n(&_displayDone, true, __ATOMIC_RELEASE);
+    return nullptr;
+  }
+
+  struct timespec next;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  for (uint32_t i = 0; i < kEvents; ++i) {
+    uint8_t frame[32];
+    uint32_t length = 0;
+    uint32_t stamp = now_us();
+    frame[length++] = START_FLAG;
+    frame[length++] = READ_FLAG;
+    length += put_escaped(&frame[length], kAddress & 0xFF);
+    length += put_escaped(&frame[length], kAddress >> 8);
+    for (uint32_t b = 0; b < sizeof(stamp); ++b) {
+      length += put_escaped(&frame[length], (uint8_t)(stamp >> (8 * b)));
+    }
+    frame[length++] = END_FLAG;
+    if (write(fd, frame, length) != (ssize_t)length) {
+      break;
+    }
+
+    next.tv_nsec += (long)(length * 10u * 1000000000ULL / kBaud);
+    while (next.tv_nsec >= 1000000000L) {
+      next.tv_nsec -= 1000000000L;
+      ++next.tv_sec;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+  }
+  usleep(20000);
+  close(fd);
+  __atomic_store_n(&_displayDone, true, __ATOMIC_RELEASE);
+  return nullptr;
+}
+
+static void drain(uint32_t *decoded, uint32_t *maxLatency, uint64_t *sumLatency) {
+  lumen_available();
+  lumen_packet_t *packet;
+  while ((packet = lumen_get_first_packet()) != nullptr) {
+    uint32_t latency = now_us() - (uint32_t)packet->data._s32;
+    if (latency > *maxLatency) {
+      *maxLatency = latency;
+    }
+    *sumLatency += latency;
+    ++*decoded;
+  }
+}
+
+int main() {
+  static lumen_packet_t pool[kEvents];
+  const uint32_t renderMs[] = { 0, 5, 20, 50, 100, 250 };
+
+  if (!HMI_TransportOpenPty(nullptr)) {
+    return 1;
+  }
+  lumen_set_packet_pool(pool, kEvents);
+
+  printf("pty %s, %u events per run at %u baud, RX ring %u B\n", HMI_TransportPtyName(), kEvents, kBaud, HMI_RX_RING_SIZE);
+  for (uint32_t r = 0; r < sizeof(renderMs) / sizeof(renderMs[0]); ++r) {
+    uint32_t decoded = 0;
+    uint32_t maxLatency = 0;
+    uint64_t sumLatency = 0;
+    uint32_t malformedBefore, resyncsBefore, malformed, resyncs;
+    lumen_rx_errors(&malformedBefore, &resyncsBefore);
+    HMI_TransportResetStats();
+
+    pthread_t thread;
+    __atomic_store_n(&_displayDone, false, __ATOMIC_RELAXED);
+    pthread_create(&thread, nullptr, display, nullptr);
+    while (!__atomic_load_n(&_displayDone, __ATOMIC_ACQUIRE)) {
+      if (renderMs[r] > 0) {
+        usleep(renderMs[r] * 1000u);
+      }
+      drain(&decoded, &maxLatency, &sumLatency);
+      if (renderMs[r] == 0) {
+        usleep(200);
+      }
+    }
+    pthread_join(thread, nullptr);
+    drain(&decoded, &maxLatency, &sumLatency);
+
+    HmiTransportStats stats;
+    HMI_TransportStats(&stats);
+    lumen_rx_errors(&malformed, &resyncs);
+    printf("render %3u ms  decoded %3u/%u  lost %5u B  ring peak %5u B  ring wait max %7.2f ms avg %6.2f ms  "
+           "event latency max %7.2f ms avg %6.2f ms  malformed %u resyncs %u\n",
+           renderMs[r], decoded, kEvents, stats.lost, stats.peak, stats.maxLatencyUs / 1000.0, stats.avgLatencyUs / 1000.0,
+           maxLatency / 1000.0, decoded ? sumLatency / 1000.0 / decoded : 0.0, malformed - malformedBefore,
+           resyncs - resyncsBefore);
+  }
+
+  HMI_TransportClose();
+  return 0;
+}
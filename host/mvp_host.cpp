@@ -0,0 +1,47 @@
+// Host build of the firmware: MVP.ino's setup() and loop() on the Arduino
+// shim in host/shim, with the HMI UART (HMIserial) on a pty.
+//
+// Start hmi_sim first and pass the pty it prints, or start this first and
+// pass the pty printed here to hmi_sim --pty:
+//   ./mvp_host /dev/pts/N [--for MS]
+//   ./mvp_host [--for MS]
+// The sketch's console (Serial) goes to stderr. With --for it returns after
+// MS ms of loop(). /config.json is read from SPIFFS_ROOT, the MVP folder by
+// default.
+//
+// Built by host/CMakeLists.txt.
+
+#include "../MVP/MVP.ino"
+
+int main(int argc, char **argv) {
+  const char *path = nullptr;
+  long forMs = -1;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--for") == 0 && i + 1 < argc) {
+      forMs = strtol(argv[++i], nullptr, 10);
+    } else if (argv[i][0] != '-' && path == nullptr) {
+      path = argv[i];
+    } else {
+      fprintf(stderr, "usage: %s [pty] [--for MS]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (!HMIserial.host_attach(path)) {
+    return 1;
+  }
+  if (path == nullptr) {
+    fprintf(stderr, "HMI UART on %s\n", HMIserial.host_pty_name());
+  }
+
+  setup();
+  unsigned long start = millis();
+  while (forMs < 0 || (long)(millis() - start) < forMs) {
+    loop();
+    // One core on the host is shared with the simulator; the ESP32 has its own.
+    yield();
+  }
+  HMIserial.end();
+  return 0;
+}
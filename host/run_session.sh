@@ -0,0 +1,39 @@
+#!/bin/sh
+# Plays an HMI session against the host firmware: hmi_sim on a new pty and
+# mvp_host on the other end, both from the build folder given first. The
+# remaining arguments go to hmi_sim. Prints its report and exits with its
+# status (non-zero on malformed frames or failed expectations). The
+# firmware's console goes to $FW_LOG when set; $MVP_HOST picks another
+# firmware binary (mvp_host_minimal).
+#   sh run_session.sh build [--baud N] [--script file] [--json]
+
+bin=$1
+shift
+log=$(mktemp)
+
+"$bin/hmi_sim" "$@" 2>"$log" &
+sim=$!
+
+pty=""
+for i in $(seq 50); do
+  pty=$(sed -n 's/^HMI on \([^,]*\),.*/\1/p' "$log")
+  [ -n "$pty" ] && break
+  sleep 0.1
+done
+if [ -z "$pty" ]; then
+  cat "$log" >&2
+  kill $sim 2>/dev/null
+  rm -f "$log"
+  exit 1
+fi
+
+"${MVP_HOST:-$bin/mvp_host}" "$pty" 2>"${FW_LOG:-/dev/null}" &
+fw=$!
+
+wait $sim
+status=$?
+kill $fw 2>/dev/null
+wait $fw 2>/dev/null
+cat "$log" >&2
+rm -f "$log"
+exit $status
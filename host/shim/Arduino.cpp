@@ -0,0 +1,43 @@
+#include "Arduino.h"
+
+#include <sched.h>
+#include <time.h>
+
+static uint64_t _delayedUs = 0;
+
+static uint64_t now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+// Both clocks start at zero when the program does, as on the ESP32.
+static const uint64_t _bootUs = now_us();
+
+unsigned long millis() {
+  return (unsigned long)((now_us() - _bootUs) / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(now_us() - _bootUs);
+}
+
+void delayMicroseconds(uint32_t us) {
+  uint64_t start = now_us();
+  struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+  while (nanosleep(&ts, &ts) != 0) {
+  }
+  _delayedUs += now_us() - start;
+}
+
+void delay(uint32_t ms) {
+  delayMicroseconds(ms * 1000);
+}
+
+void yield() {
+  sched_yield();
+}
+
+uint64_t shim_delayed_us() {
+  return _delayedUs;
+}
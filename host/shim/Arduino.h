@@ -0,0 +1,32 @@
+#pragma once
+
+// Host shim for the parts of Arduino-ESP32 the sketch uses, so MVP.ino,
+// hmi_renderer.cpp and hmi_transport.cpp build and run on Linux.
+//
+// Time is the host's monotonic clock and delay() really sleeps, so code that
+// paces itself with delay() costs on the host what it costs on the ESP32.
+// shim_delayed_us() counts the time spent inside delay(), letting benchmarks
+// tell sleeping from working.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WString.h"
+#include "HardwareSerial.h"
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+uint64_t shim_delayed_us();
+
+template <class T, class L, class H>
+static inline T constrain(T value, L low, H high) {
+  return (value < low) ? (T)low : (value > high) ? (T)high : value;
+}
@@ -0,0 +1,191 @@
+#include "FS.h"
+#include "SPIFFS.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace fs {
+
+File::File(FILE *file, const std::string &path) : _file(file, fclose), _path(path) {}
+
+File::File(DIR *dir, const std::string &path, const std::string &hostPath)
+    : _dir(dir, closedir), _path(path), _hostPath(hostPath) {}
+
+const char *File::name() const {
+  size_t slash = _path.find_last_of('/');
+  return _path.c_str() + ((slash == std::string::npos) ? 0 : slash + 1);
+}
+
+// The regular files of the directory, one per call; an empty File at the end.
+File File::openNextFile(const char *mode) {
+  if (!_dir) {
+    return File();
+  }
+  struct dirent *entry;
+  while ((entry = readdir(_dir.get())) != nullptr) {
+    std::string host = _hostPath + "/" + entry->d_name;
+    struct stat info;
+    if (stat(host.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+      continue;
+    }
+    std::string hostMode = mode;
+    if (hostMode.find('b') == std::string::npos) {
+      hostMode += 'b';
+    }
+    FILE *file = fopen(host.c_str(), hostMode.c_str());
+    if (file != nullptr) {
+      return File(file, _path + ((_path.empty() || _path.back() != '/') ? "/" : "") + entry->d_name);
+    }
+  }
+  return File();
+}
+
+size_t File::size() const {
+  if (!_file) {
+    return 0;
+  }
+  struct stat info;
+  fflush(_file.get());
+  return (fstat(fileno(_file.get()), &info) == 0) ? (size_t)info.st_size : 0;
+}
+
+size_t File::position() const {
+  return _file ? (size_t)ftell(_file.get()) : 0;
+}
+
+bool File::seek(uint32_t position) {
+  return _file && fseek(_file.get(), (long)position, SEEK_SET) == 0;
+}
+
+int File::available() {
+  if (!_file) {
+    return 0;
+  }
+  size_t total = size();
+  size_t at = position();
+  return (at < total) ? (int)(total - at) : 0;
+}
+
+int File::peek() {
+  if (!_file) {
+    return -1;
+  }
+  int c = fgetc(_file.get());
+  if (c != EOF) {
+    ungetc(c, _file.get());
+  }
+  return (c == EOF) ? -1 : c;
+}
+
+int File::read() {
+  if (!_file) {
+    return -1;
+  }
+  int c = fgetc(_file.get());
+  return (c == EOF) ? -1 : c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size) {
+  return _file ? fread(buffer, 1, size, _file.get()) : 0;
+}
+
+size_t File::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+  return _file ? fwrite(buffer, 1, size, _file.get()) : 0;
+}
+
+void File::flush() {
+  if (_file) {
+    fflush(_file.get());
+  }
+}
+
+void File::close() {
+  _file.reset();
+  _dir.reset();
+}
+
+std::string FS::hostPath(const char *path) const {
+  std::string host = _root;
+  if (path[0] != '/') {
+    host += '/';
+  }
+  return host + path;
+}
+
+File FS::open(const char *path, const char *mode, bool create) {
+  (void)create;
+  std::string host = hostPath(path);
+  struct stat info;
+  if (stat(host.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+    DIR *dir = opendir(host.c_str());
+    return dir ? File(dir, path, host) : File();
+  }
+  // "r" on a missing file fails, like on the ESP32; "w" and "a" create it.
+  std::string hostMode = mode;
+  if (hostMode.find('b') == std::string::npos) {
+    hostMode += 'b';
+  }
+  FILE *file = fopen(host.c_str(), hostMode.c_str());
+  return file ? File(file, path) : File();
+}
+
+bool FS::exists(const char *path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char *path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+}  // namespace fs
+
+#ifndef SHIM_SPIFFS_ROOT
+#define SHIM_SPIFFS_ROOT "."
+#endif
+
+// The ESP32's default SPIFFS partition.
+static const size_t kSpiffsSize = 1408 * 1024;
+
+SPIFFSFS SPIFFS;
+
+SPIFFSFS::SPIFFSFS() : fs::FS(getenv("SPIFFS_ROOT") ? getenv("SPIFFS_ROOT") : SHIM_SPIFFS_ROOT) {}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel) {
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  struct stat info;
+  return stat(_root.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+size_t SPIFFSFS::totalBytes() {
+  return kSpiffsSize;
+}
+
+size_t SPIFFSFS::usedBytes() {
+  size_t used = 0;
+  DIR *dir = opendir(_root.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    struct stat info;
+    if (stat(hostPath(entry->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+      used += (size_t)info.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
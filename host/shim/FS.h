@@ -0,0 +1,69 @@
+#pragma once
+
+// Host shim: Arduino-ESP32 fs::File and fs::FS on top of stdio. A file
+// system is a directory of the host, so "/config.json" is <root>/config.json.
+// Opening a directory gives a File to walk with openNextFile(), as on the
+// ESP32; name() is the last path component and path() the whole path, as in
+// core 2.x.
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <string>
+
+namespace fs {
+
+class File {
+public:
+  File() {}
+  File(FILE *file, const std::string &path);
+  File(DIR *dir, const std::string &path, const std::string &hostPath);
+
+  operator bool() const { return _file != nullptr || _dir != nullptr; }
+  const char *name() const;
+  const char *path() const { return _path.c_str(); }
+  bool isDirectory() const { return _dir != nullptr; }
+  File openNextFile(const char *mode = "r");
+  size_t size() const;
+  size_t position() const;
+  bool seek(uint32_t position);
+  int available();
+  int peek();
+  int read();
+  size_t read(uint8_t *buffer, size_t size);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *buffer, size_t size);
+  void flush();
+  void close();
+
+private:
+  std::shared_ptr<FILE> _file;
+  std::shared_ptr<DIR> _dir;
+  std::string _path;
+  std::string _hostPath;  // of a directory
+};
+
+class FS {
+public:
+  explicit FS(const char *root = ".") : _root(root) {}
+
+  File open(const char *path, const char *mode = "r", bool create = false);
+  bool exists(const char *path);
+  bool remove(const char *path);
+  bool rename(const char *from, const char *to);
+
+  void setRoot(const char *root) { _root = root; }
+  const char *root() const { return _root.c_str(); }
+
+protected:
+  std::string hostPath(const char *path) const;
+
+  std::string _root;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
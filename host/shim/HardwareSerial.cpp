@@ -0,0 +1,234 @@
+#include "HardwareSerial.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// What the ESP32 UART TX FIFO takes without blocking.
+static const int kTxFifo = 128;
+
+HardwareSerial Serial(0);
+
+HardwareSerial::HardwareSerial(int uartNumber) : _uart(uartNumber) {}
+
+HardwareSerial::~HardwareSerial() {
+  end();
+  if (_fd >= 0) {
+    close(_fd);
+  }
+  if (_peerFd >= 0) {
+    close(_peerFd);
+  }
+}
+
+static void make_raw(int fd) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+}
+
+bool HardwareSerial::host_attach(const char *path) {
+  if (path != nullptr) {
+    _fd = open(path, O_RDWR | O_NOCTTY);
+    if (_fd < 0) {
+      perror(path);
+      return false;
+    }
+    make_raw(_fd);
+    snprintf(_ptyName, sizeof(_ptyName), "%s", path);
+    return true;
+  }
+
+  _fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (_fd < 0 || grantpt(_fd) != 0 || unlockpt(_fd) != 0) {
+    perror("posix_openpt");
+    return false;
+  }
+  snprintf(_ptyName, sizeof(_ptyName), "%s", ptsname(_fd));
+  // Held open so the pty survives until the other end opens it.
+  _peerFd = open(_ptyName, O_RDWR | O_NOCTTY);
+  if (_peerFd >= 0) {
+    make_raw(_peerFd);
+  }
+  return true;
+}
+
+const char *HardwareSerial::host_pty_name() const {
+  return _ptyName;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin) {
+  (void)baud;
+  (void)config;
+  (void)rxPin;
+  (void)txPin;
+  if (_fd >= 0 && !_running) {
+    _running = true;
+    _thread = std::thread(&HardwareSerial::reader, this);
+  }
+}
+
+void HardwareSerial::end() {
+  if (_running) {
+    _running = false;
+    _thread.join();
+  }
+}
+
+void HardwareSerial::onReceive(std::function<void(void)> callback, bool onlyOnTimeout) {
+  (void)onlyOnTimeout;
+  std::lock_guard<std::mutex> guard(_lock);
+  _onReceive = callback;
+}
+
+void HardwareSerial::reader() {
+  while (_running) {
+    struct pollfd pfd = { _fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 50) <= 0 || !(pfd.revents & POLLIN)) {
+      continue;
+    }
+    uint8_t buffer[sizeof(_rx)];
+    ssize_t n = ::read(_fd, buffer, sizeof(buffer));
+    if (n <= 0) {
+      if (n < 0 && errno != EAGAIN && errno != EINTR) {
+        usleep(10000);
+      }
+      continue;
+    }
+
+    std::function<void(void)> callback;
+    {
+      std::lock_guard<std::mutex> guard(_lock);
+      for (ssize_t i = 0; i < n && _rxLength < sizeof(_rx); ++i) {
+        _rx[(_rxHead + _rxLength) % sizeof(_rx)] = buffer[i];
+        ++_rxLength;
+      }
+      callback = _onReceive;
+    }
+    if (callback) {
+      callback();
+    }
+  }
+}
+
+int HardwareSerial::available() {
+  std::lock_guard<std::mutex> guard(_lock);
+  return (int)_rxLength;
+}
+
+int HardwareSerial::peek() {
+  std::lock_guard<std::mutex> guard(_lock);
+  return _rxLength ? _rx[_rxHead] : -1;
+}
+
+int HardwareSerial::read() {
+  uint8_t value;
+  return (read(&value, 1) == 1) ? value : -1;
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size) {
+  std::lock_guard<std::mutex> guard(_lock);
+  size_t n = (size < _rxLength) ? size : _rxLength;
+  for (size_t i = 0; i < n; ++i) {
+    buffer[i] = _rx[_rxHead];
+    _rxHead = (_rxHead + 1) % sizeof(_rx);
+  }
+  _rxLength -= n;
+  return n;
+}
+
+int HardwareSerial::availableForWrite() {
+  if (_fd < 0) {
+    return kTxFifo;
+  }
+  int queued = 0;
+  if (ioctl(_fd, TIOCOUTQ, &queued) != 0) {
+    queued = 0;
+  }
+  return (queued < kTxFifo) ? kTxFifo - queued : 0;
+}
+
+void HardwareSerial::flush() {
+  if (_fd >= 0) {
+    tcdrain(_fd);
+  } else if (_uart == 0) {
+    fflush(stderr);
+  }
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  _written += (uint32_t)size;
+  if (_uart == 0) {
+    return fwrite(buffer, 1, size, stderr);
+  }
+  if (_fd < 0) {
+    return size;
+  }
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = ::write(_fd, buffer + done, size - done);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN) {
+        continue;
+      }
+      break;
+    }
+    done += (size_t)n;
+  }
+  return done;
+}
+
+size_t HardwareSerial::write(const char *text) {
+  return write((const uint8_t *)text, strlen(text));
+}
+
+size_t HardwareSerial::print(const char *text) {
+  return write(text);
+}
+
+size_t HardwareSerial::print(const String &text) {
+  return write(text.c_str());
+}
+
+size_t HardwareSerial::print(long value) {
+  return printf("%ld", value);
+}
+
+size_t HardwareSerial::println(const char *text) {
+  return write(text) + write("\r\n");
+}
+
+size_t HardwareSerial::println(const String &text) {
+  return println(text.c_str());
+}
+
+size_t HardwareSerial::println(long value) {
+  return print(value) + write("\r\n");
+}
+
+size_t HardwareSerial::printf(const char *format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  if ((size_t)length >= sizeof(buffer)) {
+    length = sizeof(buffer) - 1;
+  }
+  return write((const uint8_t *)buffer, (size_t)length);
+}
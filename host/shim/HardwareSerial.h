@@ -0,0 +1,76 @@
+#pragma once
+
+// Host shim: Arduino-ESP32 HardwareSerial.
+//
+// UART 0 (Serial) is the console and prints to stderr, keeping stdout free
+// for the output of the host tools. Any other UART is a sink that counts and
+// drops what is written, unless host_attach connects it to a pty: then writes
+// go to the pty and a reader thread plays the UART RX interrupt, filling the
+// RX buffer and calling the onReceive callback from its own thread, as the
+// ESP32's UART event task does.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "WString.h"
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial {
+public:
+  explicit HardwareSerial(int uartNumber);
+  ~HardwareSerial();
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+  void end();
+  void onReceive(std::function<void(void)> callback, bool onlyOnTimeout = false);
+
+  int available();
+  int peek();
+  int read();
+  size_t read(uint8_t *buffer, size_t size);
+  int availableForWrite();
+  void flush();
+
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *text);
+
+  size_t print(const char *text);
+  size_t print(const String &text);
+  size_t print(long value);
+  size_t println(const char *text = "");
+  size_t println(const String &text);
+  size_t println(long value);
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+  operator bool() const { return true; }
+
+  // Host only. Connects this UART to the pty at path, or to a new pty pair
+  // whose other end is then named by host_pty_name. Call before begin.
+  bool host_attach(const char *path);
+  const char *host_pty_name() const;
+  uint32_t host_bytes_written() const { return _written; }
+
+private:
+  void reader();
+
+  int _uart;
+  int _fd = -1;
+  int _peerFd = -1;
+  char _ptyName[64] = "";
+  volatile bool _running = false;
+  std::thread _thread;
+  std::mutex _lock;
+  std::function<void(void)> _onReceive;
+  uint8_t _rx[256];  // the ESP32 default RX buffer
+  size_t _rxHead = 0;
+  size_t _rxLength = 0;
+  uint32_t _written = 0;
+};
+
+extern HardwareSerial Serial;
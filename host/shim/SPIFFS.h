@@ -0,0 +1,20 @@
+#pragma once
+
+// Host shim: the SPIFFS partition is a directory. It is $SPIFFS_ROOT when
+// set, or SHIM_SPIFFS_ROOT from the build (the MVP folder, where config.json
+// lives), or the working directory.
+
+#include "FS.h"
+
+class SPIFFSFS : public fs::FS {
+public:
+  SPIFFSFS();
+
+  bool begin(bool formatOnFail = false, const char *basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+             const char *partitionLabel = nullptr);
+  void end() {}
+  size_t totalBytes();
+  size_t usedBytes();
+};
+
+extern SPIFFSFS SPIFFS;
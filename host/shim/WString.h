@@ -0,0 +1,84 @@
+#pragma once
+
+// Host shim: the Arduino String members the sketch uses, over std::string.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string>
+
+class String {
+public:
+  String(const char *text = "") : _s(text ? text : "") {}
+  String(const std::string &text) : _s(text) {}
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool reserve(unsigned int size) {
+    _s.reserve(size);
+    return true;
+  }
+
+  String &operator=(const char *text) {
+    _s = text ? text : "";
+    return *this;
+  }
+  String &operator+=(char c) {
+    _s += c;
+    return *this;
+  }
+  String &operator+=(const char *text) {
+    _s += text ? text : "";
+    return *this;
+  }
+  String &operator+=(const String &other) {
+    _s += other._s;
+    return *this;
+  }
+  bool operator==(const char *text) const { return _s == (text ? text : ""); }
+  bool operator==(const String &other) const { return _s == other._s; }
+  bool operator!=(const char *text) const { return !(*this == text); }
+  char operator[](unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+
+  int indexOf(char c, unsigned int from = 0) const { return found(_s.find(c, from)); }
+  int indexOf(const char *text, unsigned int from = 0) const { return found(_s.find(text, from)); }
+  String substring(unsigned int from) const { return substring(from, length()); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      unsigned int swap = from;
+      from = to;
+      to = swap;
+    }
+    if (from >= _s.size()) {
+      return String();
+    }
+    return String(_s.substr(from, to - from));
+  }
+
+  void toLowerCase() {
+    for (char &c : _s) {
+      c = (char)tolower((unsigned char)c);
+    }
+  }
+  void toUpperCase() {
+    for (char &c : _s) {
+      c = (char)toupper((unsigned char)c);
+    }
+  }
+  void trim() {
+    size_t first = 0;
+    while (first < _s.size() && isspace((unsigned char)_s[first])) {
+      ++first;
+    }
+    size_t last = _s.size();
+    while (last > first && isspace((unsigned char)_s[last - 1])) {
+      --last;
+    }
+    _s = _s.substr(first, last - first);
+  }
+  long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+
+private:
+  static int found(size_t position) { return (position == std::string::npos) ? -1 : (int)position; }
+
+  std::string _s;
+};
@@ -0,0 +1,184 @@
+// Host simulation: per-lane latency of queued Lumen frames.
+//
+// Models a running cure (time_curando every second, progress_permille on every
+// change) overlapping with repeated language switches that push a screenful of
+// label frames. The UART is a 128 byte FIFO draining at the configured baud and
+// loop() runs every millisecond, calling lumen_tx_drain with the free FIFO
+// space, just like MVP.ino. Latency is measured from the write call until the
+// frame's last byte leaves the wire.
+//
+// The same scenario runs twice: "single" puts every frame on one lane (a single
+// FIFO, the behaviour before lanes) and "lanes" keeps the cure updates on the
+// real-time lane and the labels on the bulk lane.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP sim_tx_lanes.c -o sim_tx_lanes && ./sim_tx_lanes [baud]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#define HOST_OWN_LUMEN_WRITE  // lumen_write_bytes below is the UART
+#include "host_common.h"
+
+#define kFifoSize 128
+#define kLoopPeriodUs 1000
+#define kSimulatedUs 3000000
+#define kLabelsPerSwitch 40
+#define kSwitchPeriodUs 250000
+#define kMaxInFlight 512
+
+typedef struct {
+  uint16_t address;
+  uint64_t enqueuedUs;
+} in_flight_t;
+
+typedef struct {
+  uint32_t frames;
+  double totalMs;
+  double maxMs;
+} lane_latency_t;
+
+static double byteUs;
+static uint64_t nowUs;
+static double wireDoneUs;
+
+static in_flight_t inFlight[kMaxInFlight];
+static uint32_t inFlightCount;
+
+static lane_latency_t latency[kQuantityOfLanes];
+
+static uint8_t frame[64];
+static uint32_t frameLength;
+
+static uint32_t fifo_free() {
+  double queued = (wireDoneUs - (double)nowUs) / byteUs;
+  if (queued <= 0) {
+    return kFifoSize;
+  }
+  return queued >= kFifoSize ? 0 : kFifoSize - (uint32_t)queued;
+}
+
+static lumen_tx_lane_t lane_of(uint16_t address) {
+  return (address == 139 || address == 141) ? kLaneRealtime : kLaneBulk;
+}
+
+static void frame_done(double doneUs) {
+  uint8_t raw[64];
+  uint32_t rawLength = 0;
+  for (uint32_t i = 1; i + 1 < frameLength; ++i) {
+    raw[rawLength++] = (frame[i] == ESCAPE_FLAG) ? (frame[++i] ^ XOR_FLAG) : frame[i];
+  }
+  uint16_t address = raw[1] | (raw[2] << 8);
+
+  for (uint32_t i = 0; i < inFlightCount; ++i) {
+    if (inFlight[i].address == address) {
+      lane_latency_t *l = &latency[lane_of(address)];
+      double ms = (doneUs - (double)inFlight[i].enqueuedUs) / 1000.0;
+      ++l->frames;
+      l->totalMs += ms;
+      if (ms > l->maxMs) {
+        l->maxMs = ms;
+      }
+      memmove(&inFlight[i], &inFlight[i + 1], (inFlightCount - i - 1) * sizeof(in_flight_t));
+      --inFlightCount;
+      return;
+    }
+  }
+}
+
+void lumen_write_bytes(uint8_t *data, uint32_t length) {
+  for (uint32_t i = 0; i < length; ++i) {
+    if (wireDoneUs < (double)nowUs) {
+      wireDoneUs = (double)nowUs;
+    }
+    wireDoneUs += byteUs;
+
+    if (data[i] == START_FLAG) {
+      frameLength = 0;
+    }
+    if (frameLength < sizeof(frame)) {
+      frame[frameLength++] = data[i];
+    }
+    if (data[i] == END_FLAG) {
+      frame_done(wireDoneUs);
+    }
+  }
+}
+
+static void write_tracked(uint16_t address, uint8_t *data, uint32_t length) {
+  if (inFlightCount < kMaxInFlight && lumen_write(address, data, length) > 0) {
+    inFlight[inFlightCount].address = address;
+    inFlight[inFlightCount].enqueuedUs = nowUs;
+    ++inFlightCount;
+  }
+}
+
+static void run(const char *name, bool useLanes) {
+  const uint32_t targetS = 30;
+  int32_t lastTime = -1;
+  int32_t lastProgress = -1;
+  uint32_t switches = 0;
+
+  memset(latency, 0, sizeof(latency));
+  inFlightCount = 0;
+  wireDoneUs = 0;
+  lumen_shadow_invalidate_all();
+  lumen_tx_select_lane(useLanes ? kLaneRealtime : kLaneBulk);
+
+  for (nowUs = 0; nowUs < kSimulatedUs; nowUs += kLoopPeriodUs) {
+    lumen_tx_drain(fifo_free());
+
+    int32_t elapsedS = (int32_t)(nowUs / 1000000);
+    int32_t progress = (int32_t)((nowUs / 1000) * 1000 / (targetS * 1000));
+    if (elapsedS != lastTime) {
+      lastTime = elapsedS;
+      write_tracked(139, (uint8_t *)&elapsedS, 4);
+    }
+    if (progress != lastProgress) {
+      lastProgress = progress;
+      write_tracked(141, (uint8_t *)&progress, 4);
+    }
+
+    if (nowUs % kSwitchPeriodUs == 100000) {
+      lumen_tx_lane_t lane = lumen_tx_select_lane(kLaneBulk);
+      lumen_batch_begin();
+      for (uint16_t i = 0; i < kLabelsPerSwitch; ++i) {
+        char label[MAX_STRING_SIZE];
+        snprintf(label, sizeof(label), "%c%u-%u", useLanes ? 'L' : 'S', switches, i);
+        write_tracked(150 + i, (uint8_t *)label, (uint32_t)strlen(label) + 1);
+      }
+      lumen_batch_commit();
+      lumen_tx_select_lane(lane);
+      ++switches;
+    }
+
+    lumen_tx_drain(fifo_free());
+  }
+  lumen_tx_flush();
+
+  static const char *trafficNames[kQuantityOfLanes] = { "cure", "labels" };
+  for (uint8_t lane = 0; lane < kQuantityOfLanes; ++lane) {
+    lane_latency_t *l = &latency[lane];
+    printf("%-7s %-7s frames %5u  avg %7.2f ms  max %7.2f ms\n",
+           name, trafficNames[lane], l->frames, l->frames ? l->totalMs / l->frames : 0.0, l->maxMs);
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t baud = (argc > 1) ? (uint32_t)atoi(argv[1]) : 115200;
+  byteUs = 10.0 * 1e6 / baud;
+  printf("baud %u, %u labels per language switch every %u ms\n", baud, kLabelsPerSwitch, kSwitchPeriodUs / 1000);
+
+  run("single", false);
+  run("lanes", true);
+
+  for (uint8_t lane = 0; lane < kQuantityOfLanes; ++lane) {
+    uint32_t peak = 0;
+    uint32_t rejected = 0;
+    lumen_tx_stats((lumen_tx_lane_t)lane, &peak, &rejected);
+    printf("lane %u queue peak %u B, rejected %u frames\n", lane, peak, rejected);
+  }
+  return 0;
+}
@@ -0,0 +1,307 @@
+// Host test: two Lumen contexts driven at once, as with two displays.
+//
+// Each context gets its own stream of HMI reply frames, cut into random
+// slices that arrive interleaved with the other's, so both decoders sit in
+// the middle of a frame at the same time. One reads through the block reader
+// (getBytes), the other a byte at a time. Every packet must come out of the
+// context it was sent to, in order, with nothing from the other. Then the
+// shadow: a value one context already sent is skipped there but still sent on
+// the other, and invalidating one context leaves the other alone. Last the TX
+// queues: frames written to one context, batched or not, stay in its queue
+// until it is drained and reach only its own transport.
+// Exits non-zero on the first failure.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP test_ctx.c -o test_ctx && ./test_ctx
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#include "host_common.h"
+
+#define kEvents 100000u
+#define kStreamSize (kEvents * 16u)
+#define kSinkSize 4096u
+
+// One display: what it sends the firmware and what the firmware sent it.
+typedef struct {
+  const char *name;
+  uint8_t rx[kStreamSize];
+  uint32_t rxLength;   // bytes delivered so far
+  uint32_t rxIndex;    // bytes the decoder has taken
+  uint32_t rxTotal;    // bytes of the whole stream
+  uint8_t tx[kSinkSize];
+  uint32_t txLength;
+} link_t;
+
+static link_t _links[2];
+static uint8_t _stream[2][kStreamSize];
+
+static void link_write_bytes(void *user, uint8_t *data, uint32_t length) {
+  link_t *link = (link_t *)user;
+  if (link->txLength + length <= kSinkSize) {
+    memcpy(&link->tx[link->txLength], data, length);
+  }
+  link->txLength += length;
+}
+
+static uint16_t link_get_byte(void *user) {
+  link_t *link = (link_t *)user;
+  return (link->rxIndex < link->rxLength) ? link->rx[link->rxIndex++] : DATA_NULL;
+}
+
+static uint32_t link_get_bytes(void *user, uint8_t *data, uint32_t max) {
+  link_t *link = (link_t *)user;
+  uint32_t length = link->rxLength - link->rxIndex;
+  if (length > max) {
+    length = max;
+  }
+  memcpy(data, &link->rx[link->rxIndex], length);
+  link->rxIndex += length;
+  return length;
+}
+
+static uint32_t _seed = 1;
+
+static uint32_t next_random() {
+  _seed = _seed * 1103515245u + 12345u;
+  return _seed >> 8;
+}
+
+static void put_byte(uint8_t *stream, uint32_t *length, uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    stream[(*length)++] = ESCAPE_FLAG;
+    value ^= XOR_FLAG;
+  }
+  stream[(*length)++] = value;
+}
+
+static void put_event(uint8_t *stream, uint32_t *length, uint16_t address, int32_t value) {
+  stream[(*length)++] = START_FLAG;
+  stream[(*length)++] = READ_FLAG;
+  put_byte(stream, length, address & 0xFF);
+  put_byte(stream, length, address >> 8);
+  for (uint8_t i = 0; i < sizeof(value); ++i) {
+    put_byte(stream, length, (uint8_t)(value >> (8 * i)));
+  }
+  stream[(*length)++] = END_FLAG;
+}
+
+// Values carry the context in the top byte and a sequence number below, so
+// a packet from the wrong context or out of order shows up as a wrong value.
+static int32_t tagged(uint8_t context, uint32_t sequence) {
+  return (int32_t)(((uint32_t)context << 24) | sequence);
+}
+
+static int interleaved_rx(lumen_ctx_t *contexts) {
+  uint32_t expected[2] = { 0, 0 };
+
+  _seed = 1;
+  for (uint8_t c = 0; c < 2; ++c) {
+    link_t *link = &_links[c];
+    link->rxLength = 0;
+    link->rxIndex = 0;
+    link->rxTotal = 0;
+    for (uint32_t i = 0; i < kEvents; ++i) {
+      // Values with flag bytes in them make both decoders unescape.
+      uint32_t sequence = (i % 5 == 0) ? (i & 0xFFFF00u) | END_FLAG : i;
+      put_event(_stream[c], &link->rxTotal, (uint16_t)(130 + next_random() % 11), tagged(c, sequence));
+    }
+  }
+  lumen_ctx_set_get_bytes(&contexts[0], link_get_bytes);
+
+  while (_links[0].rxLength < _links[0].rxTotal || _links[1].rxLength < _links[1].rxTotal) {
+    uint8_t c = next_random() & 1;
+    link_t *link = &_links[c];
+
+    // A slice of up to three frames, cut anywhere.
+    uint32_t slice = 1 + next_random() % 48;
+    if (slice > link->rxTotal - link->rxLength) {
+      slice = link->rxTotal - link->rxLength;
+    }
+    memcpy(&link->rx[link->rxLength], &_stream[c][link->rxLength], slice);
+    link->rxLength += slice;
+
+    lumen_ctx_available(&contexts[c]);
+    lumen_packet_t *packet;
+    while ((packet = lumen_ctx_get_first_packet(&contexts[c])) != NULL) {
+      uint32_t sequence = (expected[c] % 5 == 0) ? (expected[c] & 0xFFFF00u) | END_FLAG : expected[c];
+      if (packet->data._s32 != tagged(c, sequence)) {
+        printf("FAIL: %s packet %u is %d (0x%08x), expected 0x%08x\n", _links[c].name, expected[c],
+               packet->data._s32, (uint32_t)packet->data._s32, (uint32_t)tagged(c, sequence));
+        return 1;
+      }
+      ++expected[c];
+    }
+  }
+
+  for (uint8_t c = 0; c < 2; ++c) {
+    uint32_t malformed, resyncs, dropped;
+    lumen_ctx_rx_errors(&contexts[c], &malformed, &resyncs);
+    lumen_ctx_rx_stats(&contexts[c], &dropped, NULL, NULL, NULL);
+    if (expected[c] != kEvents || malformed != 0 || resyncs != 0 || dropped != 0) {
+      printf("FAIL: %s received %u of %u, malformed %u, resyncs %u, dropped %u\n", _links[c].name, expected[c],
+             kEvents, malformed, resyncs, dropped);
+      return 1;
+    }
+  }
+  printf("OK rx        %u events per context, interleaved, each received in order by its own context\n", kEvents);
+  return 0;
+}
+
+// Sends whatever the context has queued to its transport.
+static void drain(lumen_ctx_t *ctx) {
+#if USE_TX_QUEUE
+  lumen_ctx_tx_flush(ctx);
+#else
+  (void)ctx;
+#endif
+}
+
+#if USE_SHADOW
+static int shadow(lumen_ctx_t *contexts) {
+  int32_t value = 42;
+  _links[0].txLength = 0;
+  _links[1].txLength = 0;
+
+  // A sends 200 = 42 twice: the second is skipped. B has never sent it.
+  lumen_ctx_write(&contexts[0], 200, (uint8_t *)&value, sizeof(value));
+  lumen_ctx_write(&contexts[0], 200, (uint8_t *)&value, sizeof(value));
+  lumen_ctx_write(&contexts[1], 200, (uint8_t *)&value, sizeof(value));
+  drain(&contexts[0]);
+  drain(&contexts[1]);
+  uint32_t frameA = _links[0].txLength;
+  if (frameA == 0 || _links[1].txLength != frameA) {
+    printf("FAIL: shadow sent %u bytes on A and %u on B, expected one frame each\n", _links[0].txLength,
+           _links[1].txLength);
+    return 1;
+  }
+
+  // Forgetting on A makes A send again; B still skips its repeat.
+  lumen_ctx_shadow_invalidate_all(&contexts[0]);
+  lumen_ctx_write(&contexts[0], 200, (uint8_t *)&value, sizeof(value));
+  lumen_ctx_write(&contexts[1], 200, (uint8_t *)&value, sizeof(value));
+  drain(&contexts[0]);
+  drain(&contexts[1]);
+  if (_links[0].txLength != 2 * frameA || _links[1].txLength != frameA) {
+    printf("FAIL: after invalidating A, A sent %u bytes and B %u, expected %u and %u\n", _links[0].txLength,
+           _links[1].txLength, 2 * frameA, frameA);
+    return 1;
+  }
+
+  uint32_t hits[2], misses[2];
+  lumen_ctx_shadow_stats(&contexts[0], &hits[0], &misses[0]);
+  lumen_ctx_shadow_stats(&contexts[1], &hits[1], &misses[1]);
+  if (hits[0] != 1 || misses[0] != 2 || hits[1] != 1 || misses[1] != 1) {
+    printf("FAIL: shadow stats A %u/%u B %u/%u (hits/misses), expected 1/2 and 1/1\n", hits[0], misses[0], hits[1],
+           misses[1]);
+    return 1;
+  }
+  printf("OK shadow    hits and invalidation stay in their own context\n");
+  return 0;
+}
+#endif
+
+#if USE_TX_QUEUE
+// The addresses of the WRITE frames in a transport sink, in order.
+static uint32_t written_addresses(const link_t *link, uint16_t *addresses, uint32_t max) {
+  uint32_t count = 0;
+  uint8_t frame[kDataLength];
+  uint32_t length = 0;
+  bool escaped = false;
+  for (uint32_t i = 0; i < link->txLength && i < kSinkSize; ++i) {
+    uint8_t value = link->tx[i];
+    if (value == START_FLAG) {
+      length = 0;
+      escaped = false;
+    } else if (value == END_FLAG) {
+      if (length >= 3 && frame[0] == WRITE_FLAG && count < max) {
+        addresses[count++] = (uint16_t)(frame[1] | (frame[2] << 8));
+      }
+    } else if (value == ESCAPE_FLAG) {
+      escaped = true;
+    } else if (length < sizeof(frame)) {
+      frame[length++] = escaped ? (value ^ XOR_FLAG) : value;
+      escaped = false;
+    }
+  }
+  return count;
+}
+
+static int tx_queues(lumen_ctx_t *contexts) {
+  _links[0].txLength = 0;
+  _links[1].txLength = 0;
+
+  // A batches labels on its bulk lane while B writes one value on its
+  // real-time lane: B's frame must not end up in A's batch or queue.
+  lumen_ctx_tx_select_lane(&contexts[0], kLaneBulk);
+#if USE_BATCH
+  lumen_ctx_batch_begin(&contexts[0]);
+#endif
+  for (uint16_t i = 0; i < 5; ++i) {
+    char text[] = "label A";
+    text[5] = (char)('0' + i);
+    lumen_ctx_write(&contexts[0], (uint16_t)(300 + i), (uint8_t *)text, sizeof(text));
+  }
+  int32_t value = 7;
+  lumen_ctx_write(&contexts[1], 400, (uint8_t *)&value, sizeof(value));
+#if USE_BATCH
+  lumen_ctx_batch_commit(&contexts[0]);
+#endif
+  lumen_ctx_tx_select_lane(&contexts[0], kLaneRealtime);
+
+  if (_links[0].txLength != 0 || _links[1].txLength != 0) {
+    printf("FAIL: frames reached a transport before any drain\n");
+    return 1;
+  }
+  uint32_t pendingA = lumen_ctx_tx_pending(&contexts[0]);
+  uint32_t pendingB = lumen_ctx_tx_pending(&contexts[1]);
+  if (pendingA == 0 || pendingB == 0) {
+    printf("FAIL: queued %u bytes on A and %u on B, expected both non-empty\n", pendingA, pendingB);
+    return 1;
+  }
+
+  // Draining B sends B's frame only, and leaves A's queue as it was.
+  drain(&contexts[1]);
+  uint16_t addresses[8];
+  if (lumen_ctx_tx_pending(&contexts[0]) != pendingA || _links[0].txLength != 0 ||
+      written_addresses(&_links[1], addresses, 8) != 1 || addresses[0] != 400) {
+    printf("FAIL: draining B touched A or sent something other than 400\n");
+    return 1;
+  }
+
+  drain(&contexts[0]);
+  uint32_t count = written_addresses(&_links[0], addresses, 8);
+  if (count != 5 || _links[1].txLength != pendingB) {
+    printf("FAIL: A sent %u frames, expected 5, and B's transport grew to %u bytes\n", count, _links[1].txLength);
+    return 1;
+  }
+  for (uint16_t i = 0; i < 5; ++i) {
+    if (addresses[i] != 300 + i) {
+      printf("FAIL: A frame %u went to %u, expected %u\n", i, addresses[i], 300 + i);
+      return 1;
+    }
+  }
+  printf("OK tx queue  each context's frames leave through its own queue and transport\n");
+  return 0;
+}
+#endif
+
+int main() {
+  static lumen_ctx_t contexts[2];
+  _links[0].name = "A";
+  _links[1].name = "B";
+  for (uint8_t c = 0; c < 2; ++c) {
+    lumen_ctx_init(&contexts[c], link_write_bytes, link_get_byte, &_links[c]);
+  }
+
+  int failed = interleaved_rx(contexts);
+#if USE_SHADOW
+  failed = failed || shadow(contexts);
+#endif
+#if USE_TX_QUEUE
+  failed = failed || tx_queues(contexts);
+#endif
+  return failed;
+}
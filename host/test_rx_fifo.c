@@ -0,0 +1,227 @@
+// Host test: RX packet queue order under interleaved event floods.
+//
+// Sends bursts of HMI reply frames mixing timer_start_stop (140) commands
+// with preset slider values (130-136), reading the queue back at random
+// points, and checks that packets come out exactly in arrival order, that
+// a full queue drops only the newest packets, and that nothing is lost
+// otherwise. A second pass registers 130-136 with lumen_coalesce and checks
+// that sliders keep only their latest value while every 140 event is kept.
+// A third pass swaps in a caller-provided pool of another size. Every pass
+// also checks the drop and high-water counters of lumen_rx_stats. A last
+// pass sets a schema and checks that packets come out typed and that a
+// payload of the wrong size is dropped.
+// Exits non-zero on the first failure.
+//
+// Build and run from this folder:
+//   gcc -O2 -I../MVP test_rx_fifo.c -o test_rx_fifo && ./test_rx_fifo
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../MVP/LumenProtocol.c"
+#define HOST_OWN_LUMEN_READ  // lumen_get_byte(s) below read the burst buffer
+#include "host_common.h"
+
+#define kEvents 200000u
+#define kPoolSize 24u
+#define kMaxBurst (3u * kPoolSize)
+
+static uint8_t _rx[kMaxBurst * 16];
+static uint32_t _rxLength = 0;
+static uint32_t _rxIndex = 0;
+
+uint16_t lumen_get_byte() {
+  return (_rxIndex < _rxLength) ? _rx[_rxIndex++] : DATA_NULL;
+}
+
+uint32_t lumen_get_bytes(uint8_t *data, uint32_t max) {
+  uint32_t length = _rxLength - _rxIndex;
+  if (length > max) {
+    length = max;
+  }
+  memcpy(data, &_rx[_rxIndex], length);
+  _rxIndex += length;
+  return length;
+}
+
+static void put_byte(uint8_t value) {
+  if (value == START_FLAG || value == END_FLAG || value == ESCAPE_FLAG) {
+    _rx[_rxLength++] = ESCAPE_FLAG;
+    value ^= XOR_FLAG;
+  }
+  _rx[_rxLength++] = value;
+}
+
+static void put_event(uint16_t address, int32_t value) {
+  _rx[_rxLength++] = START_FLAG;
+  _rx[_rxLength++] = READ_FLAG;
+  put_byte(address & 0xFF);
+  put_byte(address >> 8);
+  for (uint8_t i = 0; i < sizeof(value); ++i) {
+    put_byte((uint8_t)(value >> (8 * i)));
+  }
+  _rx[_rxLength++] = END_FLAG;
+}
+
+static uint32_t _seed = 1;
+
+static uint32_t next_random() {
+  _seed = _seed * 1103515245u + 12345u;
+  return _seed >> 8;
+}
+
+static bool is_slider(uint16_t address) {
+  return address >= 130 && address <= 136;
+}
+
+static int run(bool coalesce, lumen_packet_t *pool, uint16_t capacity) {
+  // What the queue should hold, in order; a model of the FIFO.
+  static uint16_t expectedAddress[kEvents];
+  static int32_t expectedValue[kEvents];
+  uint32_t expectedHead = 0;
+  uint32_t expectedTail = 0;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  uint32_t dropped = 0;
+  uint32_t coalesced = 0;
+  int32_t sequence = 0;
+
+  uint32_t peak = 0;
+
+  _seed = 1;
+  lumen_ctx_init(lumen_default_ctx(), lumen_default_write_bytes, lumen_default_get_byte, NULL);
+  lumen_ctx_set_get_bytes(lumen_default_ctx(), lumen_default_get_bytes);
+  if (pool != NULL) {
+    lumen_set_packet_pool(pool, capacity);
+  }
+  if (coalesce) {
+    lumen_coalesce(130, 136);
+  }
+
+  while (sent < kEvents) {
+    uint32_t burst = 1 + next_random() % kMaxBurst;
+    _rxLength = 0;
+    _rxIndex = 0;
+
+    for (uint32_t i = 0; i < burst && sent < kEvents; ++i, ++sent) {
+      // Odd sequence numbers are start, even are pause, so any reordering
+      // of two 140 events shows up as a wrong value.
+      uint16_t address = (next_random() % 3 == 0) ? 140 : 130 + next_random() % 7;
+      int32_t value = ++sequence;
+      put_event(address, value);
+
+      uint32_t queued = expectedTail;
+      if (coalesce && is_slider(address)) {
+        while (queued < expectedHead && expectedAddress[queued] != address) {
+          ++queued;
+        }
+      }
+      if (coalesce && is_slider(address) && queued < expectedHead) {
+        expectedValue[queued] = value;
+        ++coalesced;
+      } else if ((expectedHead - expectedTail) < capacity) {
+        expectedAddress[expectedHead] = address;
+        expectedValue[expectedHead] = value;
+        ++expectedHead;
+        if ((expectedHead - expectedTail) > peak) {
+          peak = expectedHead - expectedTail;
+        }
+      } else {
+        ++dropped;
+      }
+    }
+
+    uint32_t available = lumen_available();
+    if (available != (expectedHead - expectedTail)) {
+      printf("FAIL: %u packets available, expected %u\n", available, expectedHead - expectedTail);
+      return 1;
+    }
+
+    // Sometimes leave packets queued so the next burst wraps the ring.
+    uint32_t toRead = (next_random() % 4 == 0) ? available / 2 : available;
+    for (uint32_t i = 0; i < toRead; ++i) {
+      lumen_packet_t *packet = lumen_get_first_packet();
+      if (packet == NULL) {
+        printf("FAIL: queue empty after %u packets\n", received);
+        return 1;
+      }
+      if (packet->address != expectedAddress[expectedTail] || packet->data._s32 != expectedValue[expectedTail]) {
+        printf("FAIL: packet %u is %u=%d, expected %u=%d\n", received, packet->address, packet->data._s32,
+               expectedAddress[expectedTail], expectedValue[expectedTail]);
+        return 1;
+      }
+      ++expectedTail;
+      ++received;
+    }
+  }
+
+  while (lumen_get_first_packet() != NULL) {
+    ++received;
+    ++expectedTail;
+  }
+  if (expectedTail != expectedHead || (received + dropped + coalesced) != sent) {
+    printf("FAIL: sent %u, received %u, dropped %u, coalesced %u\n", sent, received, dropped, coalesced);
+    return 1;
+  }
+
+  uint32_t statsDropped, statsOverruns, statsTruncated, statsPeak;
+  lumen_rx_stats(&statsDropped, &statsOverruns, &statsTruncated, &statsPeak);
+  if (statsDropped != dropped || statsPeak != peak || statsOverruns != 0 || statsTruncated != 0) {
+    printf("FAIL: stats dropped %u peak %u overruns %u truncated %u, expected dropped %u peak %u\n", statsDropped,
+           statsPeak, statsOverruns, statsTruncated, dropped, peak);
+    return 1;
+  }
+
+  printf("OK %-9s %u events, %u received in order, %u coalesced, %u dropped on a full queue (capacity %u, peak %u)\n",
+         coalesce ? "coalesce" : "fifo", sent, received, coalesced, dropped, capacity, peak);
+  return 0;
+}
+
+#if USE_SCHEMA
+static int schema() {
+  static const lumen_variable_t variables[] = { { 140, kS32 }, { 141, kU16 } };
+
+  lumen_ctx_init(lumen_default_ctx(), lumen_default_write_bytes, lumen_default_get_byte, NULL);
+  lumen_ctx_set_get_bytes(lumen_default_ctx(), lumen_default_get_bytes);
+  if (!lumen_set_schema(variables, 2)) {
+    printf("FAIL: schema rejected\n");
+    return 1;
+  }
+
+  // 141 is a U16, so its 4-byte payload does not fit; 150 has no schema entry.
+  _rxLength = 0;
+  _rxIndex = 0;
+  put_event(140, -7);
+  put_event(141, 1000);
+  put_event(150, 3);
+
+  lumen_packet_t *packet;
+  if (lumen_available() != 2 || (packet = lumen_get_first_packet()) == NULL || packet->address != 140 ||
+      packet->type != kS32 || packet->data._s32 != -7) {
+    printf("FAIL: 140 not received as S32 -7\n");
+    return 1;
+  }
+  if ((packet = lumen_get_first_packet()) == NULL || packet->address != 150 || packet->type != kString) {
+    printf("FAIL: 150 not received as raw payload\n");
+    return 1;
+  }
+
+  uint32_t typed, mistyped;
+  lumen_schema_stats(&typed, &mistyped);
+  if (typed != 1 || mistyped != 1) {
+    printf("FAIL: schema stats typed %u mistyped %u, expected 1 and 1\n", typed, mistyped);
+    return 1;
+  }
+  printf("OK schema    typed, wrong-size payload dropped\n");
+  return 0;
+}
+#endif
+
+int main() {
+  static lumen_packet_t pool[kPoolSize];
+  int failed = run(false, NULL, QUANTITY_OF_PACKETS) || run(true, NULL, QUANTITY_OF_PACKETS) || run(true, pool, kPoolSize);
+#if USE_SCHEMA
+  failed = failed || schema();
+#endif
+  return failed;
+}